@@ -13,6 +13,8 @@
 #include "unistd.h"
 #include "synchronization.h"
 #include "tty.h"
+#include "merge.h"
+#include "scheduler.h"
 
 /*---------------------------------
  * Memory Management Variables
@@ -21,6 +23,7 @@ static unsigned char *frame_bitmap;
 static pte_t *page_table_region0;
 static trap_handler trap_table[TRAP_VECTOR_SIZE];
 static int bit_vector_size;
+static int free_frame_count;
 static int current_kernel_brk_page;
 static int is_vm_enabled = 0;
 static int switch_flag = 0;
@@ -46,6 +49,7 @@ int GetFrame()
       {
         // Mark the bit as used.
         frame_bitmap[i] |= (1 << j);
+        free_frame_count--;
         // Return the corresponding frame number.
         TracePrintf(0, "Getting free frame %d\n", i * 8 + j);
         return i * 8 + j;
@@ -59,17 +63,56 @@ void FreeFrame(int frame)
 {
   int byte = frame / 8;
   int bit = frame % 8;
+  if (frame_bitmap[byte] & (1 << bit))
+  {
+    free_frame_count++;
+  }
   frame_bitmap[byte] &= ~(1 << bit);
   TracePrintf(0, "Freeing frame %d\n", frame);
 }
 
+int GetUserFrame(pcb_t *pcb)
+{
+  if (IsOverLimit(pcb, LIMIT_FRAMES, pcb->num_frames))
+  {
+    TracePrintf(0, "GetUserFrame: Process %d reached its frame limit\n", pcb->pid);
+    return -1;
+  }
+
+  int frame = GetFrame();
+  if (frame != -1)
+  {
+    pcb->num_frames++;
+  }
+  return frame;
+}
+
+void FreeUserFrame(pcb_t *pcb, int frame)
+{
+  // A merged frame stays allocated until its last mapping goes away
+  if (!ReleaseMergedFrame(frame))
+  {
+    FreeFrame(frame);
+  }
+  pcb->num_frames--;
+}
+
 void AllocateFrame(int frame)
 {
   int byte = frame / 8;
   int bit = frame % 8;
+  if ((frame_bitmap[byte] & (1 << bit)) == 0)
+  {
+    free_frame_count--;
+  }
   frame_bitmap[byte] |= (1 << bit);
 }
 
+int NumFreeFrames(void)
+{
+  return free_frame_count;
+}
+
 int IsRegion1Address(void *addr)
 {
   // Region 1 starts at VMEM_1_BASE and extends to VMEM_1_LIMIT
@@ -126,7 +169,7 @@ int GrowStackToAddress(void *addr)
   // Allocate pages from target_page up to lowest_stack_page-1
   for (int i = target_page; i < lowest_stack_page; i++)
   {
-    int frame = GetFrame();
+    int frame = GetUserFrame(current_pcb);
     if (frame == -1)
     {
       // Out of physical memory
@@ -235,6 +278,46 @@ void InitializeTrapTable()
   trap_table[TRAP_DISK] = TrapDiskHandler;
 }
 
+/*
+ * ParseBootOptions - Applies leading key=value kernel options from the command line
+ *
+ * Returns the number of arguments consumed; the first argument without an '='
+ * names the init program.
+ */
+static int ParseBootOptions(char *cmd_args[])
+{
+  int i = 0;
+  for (; cmd_args != NULL && cmd_args[i] != NULL && strchr(cmd_args[i], '=') != NULL; i++)
+  {
+    char *value = strchr(cmd_args[i], '=') + 1;
+    if (strncmp(cmd_args[i], "merge_rate=", strlen("merge_rate=")) == 0)
+    {
+      SetMergeScanRate(atoi(value));
+    }
+    else if (strncmp(cmd_args[i], "sched=", strlen("sched=")) == 0)
+    {
+      SetSchedPolicy(value);
+    }
+    else if (strncmp(cmd_args[i], "quantum=", strlen("quantum=")) == 0 && atoi(value) > 0)
+    {
+      SetQuantum(atoi(value));
+    }
+    else if (strncmp(cmd_args[i], "handoff=", strlen("handoff=")) == 0)
+    {
+      SetHandoffMode(atoi(value));
+    }
+    else if (strncmp(cmd_args[i], "lockprof=", strlen("lockprof=")) == 0)
+    {
+      SetLockProfiling(atoi(value));
+    }
+    else
+    {
+      TracePrintf(0, "ParseBootOptions: Ignoring unknown option %s\n", cmd_args[i]);
+    }
+  }
+  return i;
+}
+
 void KernelStart(char *cmd_args[], unsigned int pmem_size, UserContext *uctxt)
 {
   TracePrintf(0, "KernelStart\n");
@@ -242,10 +325,17 @@ void KernelStart(char *cmd_args[], unsigned int pmem_size, UserContext *uctxt)
   int num_frames = NUM_FRAMES(pmem_size);
   bit_vector_size = BIT_VECTOR_SIZE(num_frames);
   frame_bitmap = (unsigned char *)calloc(bit_vector_size, sizeof(unsigned char));
+  free_frame_count = num_frames;
 
   InitializeProcessQueues();
   InitSyncLists();
   InitTTY();
+  InitPageMerge(num_frames);
+  InitScheduler();
+  if (cmd_args != NULL)
+  {
+    cmd_args += ParseBootOptions(cmd_args);
+  }
 
   if (frame_bitmap == NULL)
   {
@@ -342,6 +432,7 @@ void KernelStart(char *cmd_args[], unsigned int pmem_size, UserContext *uctxt)
     TracePrintf(0, "Failed to allocate init pcb\n");
     Halt();
   }
+  init_pid = init_pcb->pid;
 
   init_pcb->kernel_stack = InitializeChildKernelStack();
   memcpy(&init_pcb->user_context, uctxt, sizeof(UserContext));
@@ -376,7 +467,7 @@ void KernelStart(char *cmd_args[], unsigned int pmem_size, UserContext *uctxt)
    */
   if (switch_flag == 0)
   {
-    pcb_enqueue(ready_processes, init_pcb);
+    MakeReady(init_pcb, SCHED_NEW);
     switch_flag = 1;
     memcpy(uctxt, &idle_pcb->user_context, sizeof(UserContext));
     SetCurrentProcess(idle_pcb);
@@ -421,26 +512,38 @@ KernelContext *KCSwitch(KernelContext *kc_in, void *curr_pcb_p, void *next_pcb_p
 
 KernelContext *KCCopy(KernelContext *kc_in, void *new_pcb_p, void *not_used)
 {
-  pcb_t *new_pcb = (pcb_t *)new_pcb_p;
+  return KCCopyN(kc_in, &new_pcb_p, (void *)1);
+}
 
-  memcpy(&new_pcb->kernel_context, kc_in, sizeof(KernelContext));
+KernelContext *KCCopyN(KernelContext *kc_in, void *children_p, void *count_p)
+{
+  pcb_t **children = (pcb_t **)children_p;
+  int count = (int)(long)count_p;
 
-  if (new_pcb->kernel_stack == NULL)
+  for (int c = 0; c < count; c++)
   {
-    new_pcb->kernel_stack = InitializeChildKernelStack();
+    memcpy(&children[c]->kernel_context, kc_in, sizeof(KernelContext));
+
+    if (children[c]->kernel_stack == NULL)
+    {
+      children[c]->kernel_stack = InitializeChildKernelStack();
+    }
   }
-  // Copy the kernel stack from the parent to the child
-  pte_t *kernel_stack = new_pcb->kernel_stack;
+
+  // Copy each page of the parent kernel stack into every child
   for (int i = 0; i < KSTACK_PAGES; i++)
   {
     unsigned int parent_addr = (KSTACK_START_PAGE + i) << PAGESHIFT; // Get the address of the current kernel stack page
-    int frame = kernel_stack[i].pfn;                                 // Get the frame number of the new process kernel stack page
-    MapScratch(frame);                                               // Temporary map the frame to the scratch address
-    memcpy((void *)(SCRATCH_ADDR), (void *)parent_addr, PAGESIZE);   // Copy the parent address to the scratch address
-    UnmapScratch();                                                  // Unmap the scratch address
-    kernel_stack[i].valid = 1;
-    kernel_stack[i].prot = PROT_READ | PROT_WRITE;
+    for (int c = 0; c < count; c++)
+    {
+      pte_t *kernel_stack = children[c]->kernel_stack;
+      MapScratch(kernel_stack[i].pfn);                               // Temporary map the child frame to the scratch address
+      memcpy((void *)(SCRATCH_ADDR), (void *)parent_addr, PAGESIZE); // Copy the parent page to the scratch address
+      kernel_stack[i].valid = 1;
+      kernel_stack[i].prot = PROT_READ | PROT_WRITE;
+    }
   }
+  UnmapScratch();
 
   WriteRegister(REG_TLB_FLUSH, TLB_FLUSH_KSTACK);
 
@@ -675,7 +778,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
     {
       // Free the physical frame
       int pfn = proc->page_table[i].pfn;
-      FreeFrame(pfn);
+      FreeUserFrame(proc, pfn);
 
       // Mark page as invalid
       proc->page_table[i].valid = 0;
@@ -697,7 +800,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
   // Allocate and map text pages
   for (int i = text_pg1; i < text_pg1 + li.t_npg; i++)
   {
-    int frame = GetFrame();
+    int frame = GetUserFrame(proc);
     if (frame < 0)
     {
       for (int i = text_pg1; i < text_pg1 + li.t_npg; i++)
@@ -706,7 +809,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
         {
           // Free the physical frame
           int pfn = proc->page_table[i].pfn;
-          FreeFrame(pfn);
+          FreeUserFrame(proc, pfn);
 
           // Mark page as invalid
           proc->page_table[i].valid = 0;
@@ -731,7 +834,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
   // Allocate and map data pages
   for (int i = data_pg1; i < data_pg1 + data_npg; i++)
   {
-    int frame = GetFrame();
+    int frame = GetUserFrame(proc);
     if (frame < 0)
     {
       for (int i = data_pg1; i < data_pg1 + data_npg; i++)
@@ -740,7 +843,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
         {
           // Free the physical frame
           int pfn = proc->page_table[i].pfn;
-          FreeFrame(pfn);
+          FreeUserFrame(proc, pfn);
 
           // Mark page as invalid
           proc->page_table[i].valid = 0;
@@ -764,7 +867,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
   // Allocate and map stack pages
   for (int i = MAX_PT_LEN - stack_npg; i < MAX_PT_LEN; i++)
   {
-    int frame = GetFrame();
+    int frame = GetUserFrame(proc);
     if (frame < 0)
     {
       for (int i = MAX_PT_LEN - stack_npg; i < MAX_PT_LEN; i++)
@@ -773,7 +876,7 @@ int LoadProgram(char *name, char *args[], pcb_t *proc)
         {
           // Free the physical frame
           int pfn = proc->page_table[i].pfn;
-          FreeFrame(pfn);
+          FreeUserFrame(proc, pfn);
 
           // Mark page as invalid
           proc->page_table[i].valid = 0;
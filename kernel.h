@@ -55,6 +55,32 @@ void FreeFrame(int frame);
  */
 void AllocateFrame(int frame);
 
+/**
+ * NumFreeFrames - Returns the number of unallocated physical frames
+ *
+ * @return Number of free frames
+ */
+int NumFreeFrames(void);
+
+/**
+ * GetUserFrame - Allocates a frame for a process's region 1 memory
+ *
+ * Charges the frame against the process's resident frame limit.
+ *
+ * @param pcb - The process the frame is allocated for
+ *
+ * @return Frame number (≥ 0) on success, -1 if the process is at its frame limit or no free frames are available
+ */
+int GetUserFrame(pcb_t *pcb);
+
+/**
+ * FreeUserFrame - Frees a region 1 frame and credits the owning process
+ *
+ * @param pcb - The process the frame belonged to
+ * @param frame - The frame number to free
+ */
+void FreeUserFrame(pcb_t *pcb, int frame);
+
 /**
  * IsRegion1Address - Checks if an address is in region 1
  *
@@ -152,6 +178,21 @@ KernelContext *KCSwitch(KernelContext *kc_in, void *curr_pcb_p, void *next_pcb_p
  */
 KernelContext *KCCopy(KernelContext *kc_in, void *new_pcb_p, void *not_used);
 
+/**
+ * KCCopyN - Kernel context copy function for forking several children at once
+ *
+ * Copies the kernel context and kernel stack into every child in a single
+ * kernel context switch, touching each parent stack page once and flushing
+ * the TLB once.
+ *
+ * @param kc_in - Current kernel context
+ * @param children_p - Array of pointers to the new process control blocks
+ * @param count_p - Number of children in the array, cast to a pointer
+ *
+ * @return The original kernel context pointer
+ */
+KernelContext *KCCopyN(KernelContext *kc_in, void *children_p, void *count_p);
+
 /**
  * InitializeKernelStack - Initializes the kernel stack
  *
@@ -0,0 +1,267 @@
+#include "merge.h"
+#include "kernel.h"
+#include "ykernel.h"
+#include "yalnix.h"
+#include "process.h"
+
+/**
+ * Candidate Page
+ *
+ * A page hashed by the idle scan. Entries are never invalidated; a hit is
+ * checked against the owner's page table and compared in full before merging.
+ */
+typedef struct merge_candidate
+{
+  int used;          // Whether this slot holds a candidate
+  int pid;           // Owner of the page
+  int index;         // Region 1 page table index in the owner
+  int pfn;           // Frame the page was mapped to when hashed
+  unsigned int hash; // Hash of the page contents
+} merge_candidate_t;
+
+static int *share_count;                              // Per frame: number of mappings beyond the first
+static merge_candidate_t *table;                      // Candidate pages, direct-mapped by hash
+static char *page_buffer;                             // Copy of the page being scanned, for comparison
+static int merge_scan_rate = MERGE_DEFAULT_SCAN_RATE; // Pages examined per idle tick
+static int cursor_pid = -1;                           // Process the scan stopped in, -1 to start over
+static int cursor_index = 0;                          // Next page table index to scan in that process
+static merge_stats_t merge_stats;                     // Running totals reported by SysMergeControl
+
+void InitPageMerge(int num_frames)
+{
+  share_count = (int *)calloc(num_frames, sizeof(int));
+  table = (merge_candidate_t *)calloc(MERGE_TABLE_SIZE, sizeof(merge_candidate_t));
+  page_buffer = (char *)malloc(PAGESIZE);
+  if (share_count == NULL || table == NULL || page_buffer == NULL)
+  {
+    TracePrintf(0, "InitPageMerge: Failed to allocate merge tables\n");
+    Halt();
+  }
+}
+
+void SetMergeScanRate(int rate)
+{
+  merge_scan_rate = rate;
+  TracePrintf(1, "SetMergeScanRate: Scanning %d pages per idle tick\n", merge_scan_rate);
+}
+
+// Only writable data pages are candidates; text stays with its own frames
+static int IsCandidatePage(pte_t *pte)
+{
+  return pte->valid && (pte->prot == (PROT_READ | PROT_WRITE) || pte->prot == PROT_READ);
+}
+
+static unsigned int HashFrame(int frame)
+{
+  MapScratch(frame);
+  memcpy(page_buffer, (void *)SCRATCH_ADDR, PAGESIZE);
+
+  unsigned int hash = 2166136261u;
+  unsigned int *words = (unsigned int *)page_buffer;
+  for (int i = 0; i < PAGESIZE / sizeof(unsigned int); i++)
+  {
+    hash = (hash ^ words[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Tries to merge page index of pcb, whose contents are in page_buffer, into the candidate
+static int TryMerge(pcb_t *pcb, int index, merge_candidate_t *candidate)
+{
+  pte_t *pte = &pcb->page_table[index];
+  pcb_t *owner = FindPCB(candidate->pid);
+  if (owner == NULL || owner->state == PCB_STATE_DEFUNCT || candidate->pfn == pte->pfn)
+  {
+    return 0;
+  }
+
+  pte_t *owner_pte = &owner->page_table[candidate->index];
+  if (!IsCandidatePage(owner_pte) || owner_pte->pfn != candidate->pfn)
+  {
+    return 0;
+  }
+
+  MapScratch(candidate->pfn);
+  if (memcmp(page_buffer, (void *)SCRATCH_ADDR, PAGESIZE) != 0)
+  {
+    return 0;
+  }
+
+  int old_frame = pte->pfn;
+  owner_pte->prot = PROT_READ;
+  pte->pfn = candidate->pfn;
+  pte->prot = PROT_READ;
+  share_count[candidate->pfn]++;
+  merge_stats.pages_merged++;
+  merge_stats.merges++;
+
+  if (!ReleaseMergedFrame(old_frame))
+  {
+    FreeFrame(old_frame);
+  }
+
+  TracePrintf(1, "MergeIdleScan: Merged pid %d page %d into frame %d (pid %d page %d)\n",
+              pcb->pid, index, candidate->pfn, owner->pid, candidate->index);
+  return 1;
+}
+
+static void ScanPage(pcb_t *pcb, int index)
+{
+  pte_t *pte = &pcb->page_table[index];
+  unsigned int hash = HashFrame(pte->pfn);
+  merge_stats.pages_scanned++;
+
+  merge_candidate_t *candidate = &table[hash % MERGE_TABLE_SIZE];
+  if (candidate->used && candidate->hash == hash && TryMerge(pcb, index, candidate))
+  {
+    return;
+  }
+
+  candidate->used = 1;
+  candidate->pid = pcb->pid;
+  candidate->index = index;
+  candidate->pfn = pte->pfn;
+  candidate->hash = hash;
+}
+
+void MergeIdleScan(void)
+{
+  if (merge_scan_rate <= 0)
+  {
+    return;
+  }
+
+  pcb_t *pcb = (cursor_pid == -1) ? NULL : FindPCB(cursor_pid);
+  if (pcb == NULL)
+  {
+    pcb = NextPCB(NULL);
+    cursor_index = 0;
+  }
+
+  // Examine up to merge_scan_rate pages, stopping after one full pass over all processes
+  int scanned = 0;
+  int wrapped = 0;
+  while (pcb != NULL && scanned < merge_scan_rate)
+  {
+    if (pcb != idle_pcb && pcb->state != PCB_STATE_DEFUNCT)
+    {
+      for (; cursor_index < NUM_PAGES_REGION1 && scanned < merge_scan_rate; cursor_index++)
+      {
+        if (IsCandidatePage(&pcb->page_table[cursor_index]))
+        {
+          ScanPage(pcb, cursor_index);
+          scanned++;
+        }
+      }
+      if (scanned == merge_scan_rate)
+      {
+        break;
+      }
+    }
+
+    pcb = NextPCB(pcb);
+    cursor_index = 0;
+    if (pcb == NULL && !wrapped)
+    {
+      pcb = NextPCB(NULL);
+      wrapped = 1;
+    }
+  }
+  UnmapScratch();
+
+  cursor_pid = (pcb != NULL) ? pcb->pid : -1;
+}
+
+int ReleaseMergedFrame(int frame)
+{
+  if (share_count[frame] > 0)
+  {
+    share_count[frame]--;
+    merge_stats.pages_merged--;
+    return 1;
+  }
+  return 0;
+}
+
+int SplitMergedPage(pcb_t *pcb, int index)
+{
+  pte_t *pte = &pcb->page_table[index];
+
+  if (share_count[pte->pfn] > 0)
+  {
+    int frame = GetFrame();
+    if (frame == -1)
+    {
+      TracePrintf(0, "SplitMergedPage: Out of frames for pid %d page %d\n", pcb->pid, index);
+      return ERROR;
+    }
+
+    MapScratch(pte->pfn);
+    memcpy(page_buffer, (void *)SCRATCH_ADDR, PAGESIZE);
+    MapScratch(frame);
+    memcpy((void *)SCRATCH_ADDR, page_buffer, PAGESIZE);
+    UnmapScratch();
+
+    ReleaseMergedFrame(pte->pfn);
+    pte->pfn = frame;
+    merge_stats.splits++;
+  }
+  pte->prot = PROT_READ | PROT_WRITE;
+
+  if (pcb == GetCurrentProcess())
+  {
+    WriteRegister(REG_TLB_FLUSH, (index + NUM_PAGES_REGION1) << PAGESHIFT);
+  }
+  TracePrintf(1, "SplitMergedPage: pid %d page %d now private in frame %d\n", pcb->pid, index, pte->pfn);
+  return SUCCESS;
+}
+
+int IsMergedPage(pcb_t *pcb, void *addr)
+{
+  if (!IsRegion1Address(addr))
+  {
+    return 0;
+  }
+  pte_t *pte = &pcb->page_table[VPN_TO_REGION1_INDEX((unsigned int)addr >> PAGESHIFT)];
+  return pte->valid && pte->prot == PROT_READ;
+}
+
+int PrepareUserWrite(void *addr, int len)
+{
+  pcb_t *pcb = GetCurrentProcess();
+  if (len <= 0)
+  {
+    return SUCCESS;
+  }
+
+  unsigned int first = (unsigned int)addr >> PAGESHIFT;
+  unsigned int last = ((unsigned int)addr + len - 1) >> PAGESHIFT;
+  for (unsigned int page = first; page <= last; page++)
+  {
+    void *page_addr = (void *)(page << PAGESHIFT);
+    if (IsMergedPage(pcb, page_addr) && SplitMergedPage(pcb, VPN_TO_REGION1_INDEX(page)) == ERROR)
+    {
+      return ERROR;
+    }
+  }
+  return SUCCESS;
+}
+
+int SysMergeControl(int scan_rate, merge_stats_t *stats)
+{
+  if (scan_rate >= 0)
+  {
+    SetMergeScanRate(scan_rate);
+  }
+
+  if (stats != NULL)
+  {
+    if (PrepareUserWrite(stats, sizeof(merge_stats_t)) == ERROR)
+    {
+      return ERROR;
+    }
+    merge_stats.scan_rate = merge_scan_rate;
+    memcpy(stats, &merge_stats, sizeof(merge_stats_t));
+  }
+  return SUCCESS;
+}
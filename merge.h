@@ -0,0 +1,108 @@
+#ifndef _MERGE_H
+#define _MERGE_H
+
+#include "hardware.h"
+#include "process.h"
+
+#define MERGE_TABLE_SIZE 256       // Slots in the candidate page table
+#define MERGE_DEFAULT_SCAN_RATE 16 // Pages examined per idle clock tick
+
+/**
+ * Page Merging Statistics
+ *
+ * Filled in by SysMergeControl so user programs can watch the merger.
+ */
+typedef struct merge_stats
+{
+  int scan_rate;     // Pages examined per idle tick, 0 if merging is off
+  int pages_scanned; // Total pages hashed since boot
+  int pages_merged;  // Mappings currently sharing a frame with another mapping
+  int merges;        // Total merges since boot
+  int splits;        // Total copy-on-write splits since boot
+} merge_stats_t;
+
+/**
+ * InitPageMerge - Initialize the page merging subsystem
+ *
+ * Allocates the per-frame share counts and the candidate page table.
+ *
+ * @param num_frames - Number of physical frames in the machine
+ *
+ * Note: Halts the system if memory allocation fails
+ */
+void InitPageMerge(int num_frames);
+
+/**
+ * SetMergeScanRate - Set how many pages the idle scan examines per tick
+ *
+ * @param rate - Pages per idle tick, 0 to turn merging off
+ */
+void SetMergeScanRate(int rate);
+
+/**
+ * MergeIdleScan - Hash a batch of user pages and merge identical ones
+ *
+ * Called from the clock handler while the idle process is running. Walks
+ * every process's region 1 pages from where the last call stopped, hashing
+ * each writable page into the candidate table. When a page's hash matches
+ * a live candidate and the contents compare equal, both mappings are
+ * pointed at the candidate's frame, made read-only, and the page's own
+ * frame is freed.
+ */
+void MergeIdleScan(void);
+
+/**
+ * ReleaseMergedFrame - Drop one mapping of a possibly shared frame
+ *
+ * @param frame - The frame being unmapped
+ *
+ * @return 1 if other mappings still use the frame and it must not be freed,
+ *         0 if the caller held the last mapping and should free it
+ */
+int ReleaseMergedFrame(int frame);
+
+/**
+ * SplitMergedPage - Give a process a private, writable copy of a merged page
+ *
+ * Copies the page into a fresh frame if the frame is still shared, otherwise
+ * just restores write permission.
+ *
+ * @param pcb - Process whose page is being written
+ * @param index - Region 1 page table index of the page
+ *
+ * @return SUCCESS on success, ERROR if no frame is available for the copy
+ */
+int SplitMergedPage(pcb_t *pcb, int index);
+
+/**
+ * IsMergedPage - Check whether a region 1 address lies on a merged page
+ *
+ * @param pcb - Process owning the address
+ * @param addr - Region 1 address
+ *
+ * @return 1 if the page is valid and write-protected by the merger, 0 otherwise
+ */
+int IsMergedPage(pcb_t *pcb, void *addr);
+
+/**
+ * PrepareUserWrite - Split any merged pages in a user buffer before the kernel writes to it
+ *
+ * @param addr - Start of the region 1 buffer of the current process
+ * @param len - Length of the buffer in bytes
+ *
+ * @return SUCCESS on success, ERROR if a page could not be split
+ */
+int PrepareUserWrite(void *addr, int len);
+
+/**
+ * SysMergeControl - Tune the page merger and read its statistics
+ *
+ * @param scan_rate - New pages-per-idle-tick rate, 0 to turn merging off,
+ *                    negative to leave the rate unchanged
+ * @param stats - Region 1 buffer that receives the statistics, or NULL
+ *
+ * @return SUCCESS on success, ERROR if the stats buffer cannot be written
+ */
+int SysMergeControl(int scan_rate, merge_stats_t *stats);
+
+#endif // _MERGE_H
@@ -2,42 +2,53 @@
 #include "ykernel.h"
 #include "queue.h"
 #include "kernel.h"
+#include "scheduler.h"
+#include "timer.h"
 
-pcb_queue_t *ready_processes = NULL;
-pcb_queue_t *blocked_processes = NULL;
 pcb_queue_t *defunct_processes = NULL;
-pcb_queue_t *waiting_parent_processes = NULL;
 pcb_t *idle_pcb = NULL;
+int init_pid = -1;
+
+#define PID_TABLE_SIZE 64
+static pcb_t *pid_table[PID_TABLE_SIZE]; // Hash table of all PCBs, keyed by pid
 
 void InitializeProcessQueues()
 {
-  ready_processes = pcb_queue_create();
-  if (ready_processes == NULL)
+  defunct_processes = pcb_queue_create();
+  if (defunct_processes == NULL)
   {
-    TracePrintf(0, "InitializeProcessQueues: Failed to create ready queue\n");
+    TracePrintf(0, "InitializeProcessQueues: Failed to create defunct queue\n");
     Halt();
   }
+}
 
-  blocked_processes = pcb_queue_create();
-  if (blocked_processes == NULL)
+pcb_t *FindPCB(int pid)
+{
+  for (pcb_t *pcb = pid_table[pid % PID_TABLE_SIZE]; pcb != NULL; pcb = pcb->hash_next)
   {
-    TracePrintf(0, "InitializeProcessQueues: Failed to create blocked queue\n");
-    Halt();
+    if (pcb->pid == pid)
+    {
+      return pcb;
+    }
   }
+  return NULL;
+}
 
-  defunct_processes = pcb_queue_create();
-  if (defunct_processes == NULL)
+pcb_t *NextPCB(pcb_t *pcb)
+{
+  if (pcb != NULL && pcb->hash_next != NULL)
   {
-    TracePrintf(0, "InitializeProcessQueues: Failed to create defunct queue\n");
-    Halt();
+    return pcb->hash_next;
   }
 
-  waiting_parent_processes = pcb_queue_create();
-  if (waiting_parent_processes == NULL)
+  for (int bucket = (pcb == NULL) ? 0 : pcb->pid % PID_TABLE_SIZE + 1; bucket < PID_TABLE_SIZE; bucket++)
   {
-    TracePrintf(0, "InitializeProcessQueues: Failed to create waiting parent queue\n");
-    Halt();
+    if (pid_table[bucket] != NULL)
+    {
+      return pid_table[bucket];
+    }
   }
+  return NULL;
 }
 
 pcb_t *GetCurrentProcess()
@@ -73,13 +84,24 @@ pcb_t *CreatePCB(char *name)
   pcb->brk = NULL;
   pcb->next = NULL;
   pcb->prev = NULL;
+  pcb->queue = NULL;
   pcb->parent = NULL;
-  pcb->delay_ticks = -1;
+  pcb->first_child = NULL;
+  pcb->next_sibling = NULL;
+  pcb->prev_sibling = NULL;
+  pcb->num_children = 0;
+  pcb->waiting_for_child = 0;
+  pcb->timer_next = NULL;
+  pcb->timer_prev = NULL;
+  pcb->timer_expires = 0;
+  pcb->timer_armed = 0;
+  pcb->timer_callback = NULL;
   pcb->exit_status = 0;
-  pcb->children = pcb_queue_create();
-  if (pcb->children == NULL)
+  pcb->zombies = pcb_queue_create();
+  if (pcb->zombies == NULL)
   {
-    TracePrintf(0, "CreatePCB: Failed to allocate memory for children queue\n");
+    TracePrintf(0, "CreatePCB: Failed to allocate memory for zombie queue\n");
+    free(pcb->page_table);
     free(pcb);
     return NULL;
   }
@@ -94,67 +116,169 @@ pcb_t *CreatePCB(char *name)
   pcb->tty_write_len = 0;
   pcb->kernel_read_buffer = NULL;
   pcb->kernel_read_size = 0;
+  pcb->write_request = NULL;
+  pcb->cvar_lock_id = 0;
+  pcb->held_locks = NULL;
+  pcb->blocked_lock = NULL;
+  pcb->lock_wait_start = 0;
+  pcb->blocked_sync_id = 0;
+  pcb->rw_holds = 0;
+  pcb->wait_result = 0;
+  pcb->sync_refs = NULL;
+  pcb->num_sync_refs = 0;
+  pcb->sync_refs_capacity = 0;
+
+  for (int i = 0; i < NUM_LIMITS; i++)
+  {
+    pcb->limits[i] = LIMIT_UNLIMITED;
+  }
+  pcb->num_frames = 0;
+  pcb->cpu_ticks = 0;
+  pcb->num_sync_objects = 0;
+  pcb->sched_level = 0;
+  pcb->sched_ticks = 0;
+  pcb->slice_ticks = 0;
+  pcb->boost_window_start = 0;
+  pcb->boosts_used = 0;
+  pcb->priority = PRIO_DEFAULT;
+  pcb->base_priority = PRIO_DEFAULT;
+  pcb->sched_hint = SCHED_HINT_NORMAL;
+  pcb->vruntime = 0;
+  pcb->heap_index = -1;
+  pcb->sched_group = 0;
+  pcb->rt_period = 0;
+  pcb->rt_budget = 0;
+  pcb->rt_remaining = 0;
+  pcb->rt_deadline = 0;
+  pcb->rt_misses = 0;
+
+  // Register in the pid table so the process can be found by pid
+  int bucket = pcb->pid % PID_TABLE_SIZE;
+  pcb->hash_next = pid_table[bucket];
+  pid_table[bucket] = pcb;
 
   return pcb;
 }
 
 void DestroyPCB(pcb_t *pcb)
 {
-  if (pcb->children != NULL)
-  {
-    for (pcb_t *child = pcb->children->head; child != NULL; child = child->next)
-    {
-      child->parent = NULL;
-      child->state = PCB_STATE_ORPHAN;
-    }
-    free(pcb->children);
-  }
+  CancelTimer(pcb);
+  ReleaseChildren(pcb);
+  free(pcb->zombies);
+  FreeProcessMemory(pcb);
 
-  if (pcb->next != NULL)
+  // Unregister from the pid table
+  pcb_t **link = &pid_table[pcb->pid % PID_TABLE_SIZE];
+  while (*link != NULL && *link != pcb)
   {
-    pcb->next->prev = pcb->prev;
+    link = &(*link)->hash_next;
   }
-  if (pcb->prev != NULL)
+  if (*link == pcb)
   {
-    pcb->prev->next = pcb->next;
+    *link = pcb->hash_next;
   }
 
+  free(pcb->kernel_read_buffer);
+  free(pcb->sync_refs);
+  free(pcb->page_table);
+  free(pcb->kernel_stack);
+  free(pcb);
+}
+
+void FreeProcessMemory(pcb_t *pcb)
+{
   for (int i = 0; i < NUM_PAGES_REGION1; i++)
   {
     if (pcb->page_table[i].valid == 1)
     {
-      FreeFrame(pcb->page_table[i].pfn);
-      TracePrintf(0, "DestroyPCB: Freed frame %d for page %d\n", pcb->page_table[i].pfn, i);
+      FreeUserFrame(pcb, pcb->page_table[i].pfn);
+      pcb->page_table[i].valid = 0;
+      TracePrintf(0, "FreeProcessMemory: Freed frame %d for page %d\n", pcb->page_table[i].pfn, i);
     }
   }
 
-  free(pcb->page_table);
-  free(pcb->kernel_stack);
-  free(pcb);
-}
-
-void UpdateDelayedPCB()
-{
-  TracePrintf(0, "Calling UpdateDelay\n");
-  if (!pcb_queue_is_empty(blocked_processes))
+  if (pcb->kernel_stack != NULL)
   {
-    for (pcb_t *pcb = blocked_processes->head; pcb != NULL; pcb = pcb->next)
+    for (int i = 0; i < KSTACK_PAGES; i++)
     {
-      if (pcb->delay_ticks == -1)
+      if (pcb->kernel_stack[i].valid == 1)
       {
-        continue;
-      }
-      pcb->delay_ticks--;
-      TracePrintf(0, "The delay is now %d\n", pcb->delay_ticks);
-      if (pcb->delay_ticks == 0)
-      {
-        pcb_remove(blocked_processes, pcb);
-        pcb_enqueue(ready_processes, pcb);
+        FreeFrame(pcb->kernel_stack[i].pfn);
+        pcb->kernel_stack[i].valid = 0;
       }
     }
   }
 }
 
+void AddChild(pcb_t *parent, pcb_t *child)
+{
+  child->parent = parent;
+  child->prev_sibling = NULL;
+  child->next_sibling = parent->first_child;
+  if (parent->first_child != NULL)
+  {
+    parent->first_child->prev_sibling = child;
+  }
+  parent->first_child = child;
+  parent->num_children++;
+}
+
+void RemoveChild(pcb_t *parent, pcb_t *child)
+{
+  if (child->prev_sibling == NULL)
+  {
+    parent->first_child = child->next_sibling;
+  }
+  else
+  {
+    child->prev_sibling->next_sibling = child->next_sibling;
+  }
+
+  if (child->next_sibling != NULL)
+  {
+    child->next_sibling->prev_sibling = child->prev_sibling;
+  }
+
+  child->parent = NULL;
+  child->next_sibling = NULL;
+  child->prev_sibling = NULL;
+  parent->num_children--;
+}
+
+void ReleaseChildren(pcb_t *pcb)
+{
+  // Exited children can never be waited for again, so free them now
+  while (!pcb_queue_is_empty(pcb->zombies))
+  {
+    pcb_t *zombie = pcb_dequeue(pcb->zombies);
+    RemoveChild(pcb, zombie);
+    DestroyPCB(zombie);
+  }
+
+  // The remaining children are still running and become orphans
+  pcb_t *child = pcb->first_child;
+  while (child != NULL)
+  {
+    pcb_t *next = child->next_sibling;
+    child->parent = NULL;
+    child->next_sibling = NULL;
+    child->prev_sibling = NULL;
+    child = next;
+  }
+  pcb->first_child = NULL;
+  pcb->num_children = 0;
+}
+
+void ReapOrphans(void)
+{
+  while (!pcb_queue_is_empty(defunct_processes))
+  {
+    pcb_t *orphan = pcb_dequeue(defunct_processes);
+    TracePrintf(1, "ReapOrphans: Freeing orphan %d\n", orphan->pid);
+    DestroyPCB(orphan);
+  }
+}
+
 void PrintPageTable(pcb_t *pcb)
 {
   for (int i = 0; i < NUM_PAGES_REGION1; i++)
@@ -174,25 +298,51 @@ in page table r1 copy
 - pte_parent[1].valid = 1, .pfn = 25
 - pte_child[1].valid = 1, .pfn = 31
 */
-void CopyPageTable(pcb_t *parent, pcb_t *child)
+int CopyPageTable(pcb_t *parent, pcb_t **children, int count)
 {
   pte_t *parent_pt = parent->page_table;
-  pte_t *child_pt = child->page_table;
 
   for (int i = 0; i < NUM_PAGES_REGION1; i++)
   {
     if (parent_pt[i].valid == 1)
     {
-      int child_frame = GetFrame();
-      child_pt[i].pfn = child_frame;
-
       unsigned int parent_addr = (i + NUM_PAGES_REGION1) << PAGESHIFT;
-      MapScratch(child_frame); // Temporary map the frame to the scratch address
-      memcpy((void *)SCRATCH_ADDR, (void *)parent_addr, PAGESIZE);
-      UnmapScratch();
+      for (int c = 0; c < count; c++)
+      {
+        pte_t *child_pt = children[c]->page_table;
+        int child_frame = GetUserFrame(children[c]);
+        if (child_frame == -1)
+        {
+          TracePrintf(0, "CopyPageTable: Out of frames for child %d\n", children[c]->pid);
+          UnmapScratch();
+          return ERROR;
+        }
+        child_pt[i].pfn = child_frame;
+
+        MapScratch(child_frame); // Temporary map the frame to the scratch address
+        memcpy((void *)SCRATCH_ADDR, (void *)parent_addr, PAGESIZE);
 
-      child_pt[i].prot = parent_pt[i].prot;
-      child_pt[i].valid = 1;
+        child_pt[i].prot = parent_pt[i].prot;
+        child_pt[i].valid = 1;
+      }
     }
   }
+  UnmapScratch();
+
+  return SUCCESS;
+}
+
+int CountValidPages(pcb_t *pcb)
+{
+  int count = 0;
+  for (int i = 0; i < NUM_PAGES_REGION1; i++)
+  {
+    count += pcb->page_table[i].valid;
+  }
+  return count;
 }
+
+int IsOverLimit(pcb_t *pcb, resource_limit_t limit, int count)
+{
+  return count >= pcb->limits[limit];
+}
\ No newline at end of file
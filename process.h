@@ -18,6 +18,20 @@ typedef enum pcb_state
 
 typedef struct pcb pcb_t;
 
+/**
+ * Per-process resource limits, indexes into pcb->limits
+ */
+typedef enum resource_limit
+{
+  LIMIT_FRAMES,       // Maximum resident region 1 frames
+  LIMIT_CPU_TICKS,    // Maximum clock ticks of CPU time
+  LIMIT_SYNC_OBJECTS, // Maximum live locks, condition variables and pipes
+  LIMIT_CHILDREN,     // Maximum children not yet reaped
+  NUM_LIMITS,
+} resource_limit_t;
+
+#define LIMIT_UNLIMITED 0x7FFFFFFF // Limit value meaning no limit
+
 /**
  * Process Control Block structure - represents a process in the system
  */
@@ -35,10 +49,22 @@ struct pcb
 
   pcb_t *next;           // Next PCB in queue
   pcb_t *prev;           // Previous PCB in queue
+  pcb_queue_t *queue;    // Queue the PCB is currently on, NULL if none
+  pcb_t *hash_next;      // Next PCB in the same pid table bucket
   pcb_t *parent;         // Parent process
-  pcb_queue_t *children; // List of child processes
+  pcb_t *first_child;    // Head of the list of unreaped children
+  pcb_t *next_sibling;   // Next child of the same parent
+  pcb_t *prev_sibling;   // Previous child of the same parent
+  int num_children;      // Number of children not yet reaped by Wait
+  pcb_queue_t *zombies;  // Exited children ready to be reaped by Wait
+  int waiting_for_child; // 1 while the process is blocked in Wait
+
+  pcb_t *timer_next;                       // Next timer in the same timer wheel slot
+  pcb_t *timer_prev;                       // Previous timer in the same timer wheel slot
+  unsigned int timer_expires;              // Clock tick at which the timer fires
+  int timer_armed;                         // 1 while the timer is in the wheel
+  void (*timer_callback)(struct pcb *pcb); // Run when the timer fires
 
-  int delay_ticks; // Remaining clock ticks for delayed processes
   int exit_status; // Exit status code
 
   void *tty_read_buf;  // Buffer for TTY read operations
@@ -49,15 +75,50 @@ struct pcb
   char *kernel_read_buffer; // Buffer for kernel read operations
   int kernel_read_size;     // Size of kernel read buffer
 
+  struct write_request *write_request; // Pending pipe write while blocked in PipeWrite
+  int cvar_lock_id;                    // Lock to reacquire while blocked in CvarWait
+  struct lock *held_locks;             // Locks the process owns, linked through next_held
+  struct lock *blocked_lock;           // Lock the process is queued on, for priority inheritance
+  unsigned int lock_wait_start;        // Clock tick the process queued on blocked_lock
+  int blocked_sync_id;                 // Barrier or reader-writer lock the process is queued on, 0 if none
+  int rw_holds;                        // Read and write holds on reader-writer locks
+  int wait_result;                     // Result left for a blocked syscall by whoever wakes it, TIMEOUT if its timer did
+  int *sync_refs;                      // IDs of the sync objects the process has created or used
+  int num_sync_refs;                   // Entries in sync_refs
+  int sync_refs_capacity;              // Allocated size of sync_refs
+
+  int limits[NUM_LIMITS]; // Resource limits, inherited on fork
+  int num_frames;         // Region 1 frames currently charged to the process
+  int cpu_ticks;          // Clock ticks the process has run for
+  int num_sync_objects;   // Live locks, condition variables and pipes created by the process
+
+  int sched_level;   // MLFQ level, 0 is the highest priority
+  int sched_ticks;   // Clock ticks used of the current MLFQ quantum
+  int slice_ticks;   // Clock ticks run since the process was last dispatched
+  int priority;      // Effective priority for the prio scheduler, 0 is the highest
+  int base_priority; // Priority the process was given, before inheritance from lock waiters
+  int sched_hint;    // Workload hint (sched_hint_t), inherited on fork
+
+  unsigned int boost_window_start; // Tick the current terminal boost window began
+  int boosts_used;                 // Terminal input boosts taken in the current window
+
+  unsigned long vruntime; // Weighted virtual runtime for the cfs scheduler
+  int heap_index;         // Position in the cfs runnable heap, -1 if not in it
+  int sched_group;        // Scheduling group for the stride scheduler, inherited on fork
+
+  int rt_period;            // Real-time period in ticks, 0 for normal processes
+  int rt_budget;            // Ticks of CPU reserved per period
+  int rt_remaining;         // Budget left in the current period
+  unsigned int rt_deadline; // Tick at which the current period ends
+  int rt_misses;            // Periods whose work was not done by the deadline
+
   char *name; // Process name
 };
 
 // Global process queues and current process
-extern pcb_t *idle_pcb;                       // The idle process
-extern pcb_queue_t *ready_processes;          // Queue of processes ready to run
-extern pcb_queue_t *blocked_processes;        // Queue of blocked processes
-extern pcb_queue_t *defunct_processes;        // Queue of defunct (zombie) processes
-extern pcb_queue_t *waiting_parent_processes; // Queue of processes waiting for their children
+extern pcb_t *idle_pcb;                // The idle process
+extern int init_pid;                   // Pid of the initial program
+extern pcb_queue_t *defunct_processes; // Queue of orphaned zombies waiting to be freed
 
 static pcb_t *current_process; // Currently running process
 
@@ -74,6 +135,24 @@ static pcb_t *current_process; // Currently running process
  */
 pcb_t *CreatePCB(char *name);
 
+/**
+ * FindPCB - Looks up a live or zombie process by its pid
+ *
+ * @param pid - The process ID to look up
+ *
+ * @return Pointer to the PCB, NULL if no such process exists
+ */
+pcb_t *FindPCB(int pid);
+
+/**
+ * NextPCB - Iterates over every process in the PID table
+ *
+ * @param pcb - The process returned by the previous call, or NULL to start
+ *
+ * @return The next process, or NULL once every process has been visited
+ */
+pcb_t *NextPCB(pcb_t *pcb);
+
 /**
  * GetCurrentProcess - Returns the currently running process
  *
@@ -84,7 +163,7 @@ pcb_t *GetCurrentProcess();
 /**
  * InitializeProcessQueues - Initializes the global process queues
  *
- * Creates the ready, blocked, defunct, and waiting parent queues.
+ * Creates the ready, blocked, and defunct queues.
  * Halts the system if any queue creation fails.
  */
 void InitializeProcessQueues();
@@ -103,21 +182,59 @@ void SetCurrentProcess(pcb_t *process);
  * DestroyPCB - Cleans up and frees a process control block
  *
  * Frees all resources associated with a PCB, including page tables,
- * kernel stack, and frames. Updates parent-child relationships and
- * removes the PCB from any queues it might be in.
+ * kernel stack, and frames, and orphans any remaining children.
+ * The PCB must already have been removed from every queue and from
+ * its parent's child list.
  *
  * @param pcb - Pointer to the PCB to destroy
  */
 void DestroyPCB(pcb_t *pcb);
 
 /**
- * UpdateDelayedPCB - Updates delay counters for blocked processes
+ * AddChild - Links a newly created process into its parent's child list
+ *
+ * @param parent - Pointer to the parent PCB
+ * @param child - Pointer to the child PCB
+ */
+void AddChild(pcb_t *parent, pcb_t *child);
+
+/**
+ * RemoveChild - Unlinks a child from its parent's child list
  *
- * Decrements the delay_ticks counter for all processes in the
- * blocked queue. Moves processes to the ready queue when their
- * delay reaches zero.
+ * @param parent - Pointer to the parent PCB
+ * @param child - Pointer to the child PCB
+ */
+void RemoveChild(pcb_t *parent, pcb_t *child);
+
+/**
+ * ReleaseChildren - Detaches all children from an exiting process
+ *
+ * Frees children that have already exited (they can no longer be
+ * waited for) and orphans the ones that are still alive.
+ *
+ * @param pcb - Pointer to the exiting PCB
+ */
+void ReleaseChildren(pcb_t *pcb);
+
+/**
+ * ReapOrphans - Frees orphaned zombies left on the defunct queue
+ *
+ * An orphan cannot be freed while it is still running on its own kernel
+ * stack, so SysExit parks it on the defunct queue and the next exit
+ * frees it.
+ */
+void ReapOrphans(void);
+
+/**
+ * FreeProcessMemory - Releases the frames backing a process
+ *
+ * Frees every region 1 frame and kernel stack frame of the process and
+ * marks the entries invalid, so a later DestroyPCB does not free them twice.
+ * Must not be called on the running process.
+ *
+ * @param pcb - Pointer to the PCB whose memory to free
  */
-void UpdateDelayedPCB();
+void FreeProcessMemory(pcb_t *pcb);
 
 /**
  * PrintPageTable - Prints the contents of a process's page table
@@ -130,17 +247,41 @@ void UpdateDelayedPCB();
 void PrintPageTable(pcb_t *pcb);
 
 /**
- * CopyPageTable - Copies a page table from parent to child process
+ * CopyPageTable - Copies a page table from parent to child processes
  *
  * Creates copies of all valid pages from the parent's address space
- * to the child's address space, using temporary mapping through the
+ * to each child's address space, using temporary mapping through the
  * scratch page for copying page contents.
  *
  * @param parent - Pointer to the parent PCB
- * @param child - Pointer to the child PCB
+ * @param children - Array of pointers to the child PCBs
+ * @param count - Number of children in the array
+ *
+ * @return SUCCESS on success, ERROR if a child hits its frame limit or memory runs out
+ *
+ * Note: This function allocates new frames for the child processes. On failure the
+ *       frames already given to the children are left for DestroyPCB to free.
+ */
+int CopyPageTable(pcb_t *parent, pcb_t **children, int count);
+
+/**
+ * CountValidPages - Counts the valid region 1 pages of a process
+ *
+ * @param pcb - Pointer to the PCB
+ *
+ * @return Number of valid pages in the process's region 1 page table
+ */
+int CountValidPages(pcb_t *pcb);
+
+/**
+ * IsOverLimit - Checks whether a count has reached a process's limit
+ *
+ * @param pcb - Pointer to the PCB whose limit to check
+ * @param limit - Which limit to check
+ * @param count - The current usage
  *
- * Note: This function allocates new frames for the child process.
+ * @return 1 if another unit would exceed the limit, 0 otherwise
  */
-void CopyPageTable(pcb_t *parent, pcb_t *child);
+int IsOverLimit(pcb_t *pcb, resource_limit_t limit, int count);
 
 #endif // PROCESS_H
\ No newline at end of file
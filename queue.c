@@ -40,10 +40,35 @@ void pcb_enqueue(pcb_queue_t *queue, pcb_t *pcb)
 
   queue->tail = pcb;
   queue->size++;
+  pcb->queue = queue;
 
   TracePrintf(1, "Enqueued PCB %s (pid %d)\n", pcb->name, pcb->pid);
 }
 
+void pcb_insert_before(pcb_queue_t *queue, pcb_t *position, pcb_t *pcb)
+{
+  if (position == NULL)
+  {
+    pcb_enqueue(queue, pcb);
+    return;
+  }
+
+  pcb->next = position;
+  pcb->prev = position->prev;
+  if (position->prev == NULL)
+  {
+    queue->head = pcb;
+  }
+  else
+  {
+    position->prev->next = pcb;
+  }
+  position->prev = pcb;
+
+  queue->size++;
+  pcb->queue = queue;
+}
+
 pcb_t *pcb_dequeue(pcb_queue_t *queue)
 {
   if (!queue)
@@ -63,7 +88,14 @@ pcb_t *pcb_dequeue(pcb_queue_t *queue)
   {
     queue->tail = NULL;
   }
+  else
+  {
+    queue->head->prev = NULL;
+  }
 
+  pcb->next = NULL;
+  pcb->prev = NULL;
+  pcb->queue = NULL;
   queue->size--;
   TracePrintf(1, "Dequeued PCB %s (pid %d)\n", pcb->name, pcb->pid);
   return pcb;
@@ -105,19 +137,13 @@ void pcb_remove(pcb_queue_t *queue, pcb_t *pcb)
     pcb->next->prev = pcb->prev;
   }
 
+  pcb->next = NULL;
+  pcb->prev = NULL;
+  pcb->queue = NULL;
   queue->size--;
 }
 
 int pcb_in_queue(pcb_queue_t *queue, pcb_t *pcb)
 {
-  pcb_t *current = queue->head;
-  while (current != NULL)
-  {
-    if (current == pcb)
-    {
-      return 1;
-    }
-    current = current->next;
-  }
-  return 0;
+  return pcb->queue == queue;
 }
\ No newline at end of file
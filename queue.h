@@ -38,6 +38,17 @@ pcb_queue_t *pcb_queue_create(void);
  */
 void pcb_enqueue(pcb_queue_t *queue, pcb_t *pcb);
 
+/**
+ * pcb_insert_before - Inserts a PCB ahead of another PCB in a queue
+ *
+ * Used to keep a queue sorted. Appends to the end when position is NULL.
+ *
+ * @param queue - Pointer to the queue to add to
+ * @param position - PCB already in the queue to insert ahead of, or NULL
+ * @param pcb - Pointer to the PCB to add
+ */
+void pcb_insert_before(pcb_queue_t *queue, pcb_t *position, pcb_t *pcb);
+
 /**
  * pcb_dequeue - Removes and returns the first PCB in a queue
  *
@@ -77,7 +88,8 @@ void pcb_remove(pcb_queue_t *queue, pcb_t *pcb);
 /**
  * pcb_in_queue - Checks if a PCB is in a queue
  *
- * Searches the queue for the specified PCB.
+ * Compares the queue against the one recorded in the PCB, since a PCB
+ * can only be on one queue at a time.
  *
  * @param queue - Pointer to the queue to search
  * @param pcb - Pointer to the PCB to search for
@@ -0,0 +1,1001 @@
+#include "scheduler.h"
+#include "kernel.h"
+#include "ykernel.h"
+#include "yalnix.h"
+#include "queue.h"
+#include "timer.h"
+
+static int sched_quantum = SCHED_DEFAULT_QUANTUM; // Base quantum in clock ticks
+
+// Batch processes trade latency for fewer switches with a doubled slice
+static int SliceFor(pcb_t *pcb)
+{
+  return (pcb->sched_hint == SCHED_HINT_BATCH) ? 2 * sched_quantum : sched_quantum;
+}
+
+/*---------------------------------
+ * Round Robin
+ *--------------------------------*/
+static pcb_queue_t *rr_queue; // Single FIFO ready queue
+
+static void RRInit(void)
+{
+  rr_queue = pcb_queue_create();
+  if (rr_queue == NULL)
+  {
+    TracePrintf(0, "RRInit: Failed to create ready queue\n");
+    Halt();
+  }
+}
+
+static void RRMakeReady(pcb_t *pcb, sched_reason_t reason)
+{
+  pcb_enqueue(rr_queue, pcb);
+}
+
+static pcb_t *RRPickNext(void)
+{
+  return pcb_dequeue(rr_queue);
+}
+
+static void RRRemove(pcb_t *pcb)
+{
+  pcb_remove(rr_queue, pcb);
+}
+
+static int RRHasReady(void)
+{
+  return !pcb_queue_is_empty(rr_queue);
+}
+
+static int RRTick(pcb_t *current)
+{
+  // Every process gets one slice before going to the back of the queue
+  return current->slice_ticks >= SliceFor(current);
+}
+
+/*---------------------------------
+ * Multilevel Feedback Queue
+ *--------------------------------*/
+static pcb_queue_t *mlfq_queues[MLFQ_LEVELS]; // Ready queues, level 0 runs first
+static int mlfq_ticks_since_boost = 0;        // Busy clock ticks since the last boost
+
+static int MLFQQuantum(int level)
+{
+  return sched_quantum << level;
+}
+
+static void MLFQInit(void)
+{
+  for (int i = 0; i < MLFQ_LEVELS; i++)
+  {
+    mlfq_queues[i] = pcb_queue_create();
+    if (mlfq_queues[i] == NULL)
+    {
+      TracePrintf(0, "MLFQInit: Failed to create ready queue %d\n", i);
+      Halt();
+    }
+  }
+}
+
+static void MLFQMakeReady(pcb_t *pcb, sched_reason_t reason)
+{
+  switch (reason)
+  {
+  case SCHED_NEW:
+    pcb->sched_level = 0;
+    pcb->sched_ticks = 0;
+    break;
+  case SCHED_PREEMPTED:
+    // Used its whole quantum: a CPU hog drops a level
+    if (pcb->sched_ticks >= MLFQQuantum(pcb->sched_level))
+    {
+      if (pcb->sched_level < MLFQ_LEVELS - 1)
+      {
+        pcb->sched_level++;
+      }
+      pcb->sched_ticks = 0;
+    }
+    break;
+  case SCHED_WOKEN:
+  case SCHED_TTY_INPUT:
+    // Blocked before its quantum ran out: an interactive process climbs a level
+    if (pcb->sched_ticks < MLFQQuantum(pcb->sched_level) && pcb->sched_level > 0)
+    {
+      pcb->sched_level--;
+    }
+    pcb->sched_ticks = 0;
+    break;
+  case SCHED_REQUEUED:
+  case SCHED_YIELDED:
+    break;
+  }
+
+  // Batch work lives at the bottom; interactive work never sinks below the middle
+  if (pcb->sched_hint == SCHED_HINT_BATCH)
+  {
+    pcb->sched_level = MLFQ_LEVELS - 1;
+  }
+  else if (pcb->sched_hint == SCHED_HINT_INTERACTIVE && pcb->sched_level > MLFQ_LEVELS / 2)
+  {
+    pcb->sched_level = MLFQ_LEVELS / 2;
+  }
+
+  TracePrintf(3, "MLFQMakeReady: pid %d at level %d\n", pcb->pid, pcb->sched_level);
+  pcb_enqueue(mlfq_queues[pcb->sched_level], pcb);
+}
+
+static pcb_t *MLFQPickNext(void)
+{
+  for (int i = 0; i < MLFQ_LEVELS; i++)
+  {
+    if (!pcb_queue_is_empty(mlfq_queues[i]))
+    {
+      return pcb_dequeue(mlfq_queues[i]);
+    }
+  }
+  return NULL;
+}
+
+static int MLFQHasReady(void)
+{
+  for (int i = 0; i < MLFQ_LEVELS; i++)
+  {
+    if (!pcb_queue_is_empty(mlfq_queues[i]))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void MLFQRemove(pcb_t *pcb)
+{
+  pcb_remove(mlfq_queues[pcb->sched_level], pcb);
+}
+
+// Moves every process back to the top level so CPU hogs cannot starve
+static void MLFQBoost(void)
+{
+  TracePrintf(1, "MLFQBoost: Moving all processes to level 0\n");
+  for (pcb_t *pcb = NextPCB(NULL); pcb != NULL; pcb = NextPCB(pcb))
+  {
+    pcb->sched_level = 0;
+    pcb->sched_ticks = 0;
+  }
+
+  for (int i = 1; i < MLFQ_LEVELS; i++)
+  {
+    while (!pcb_queue_is_empty(mlfq_queues[i]))
+    {
+      pcb_enqueue(mlfq_queues[0], pcb_dequeue(mlfq_queues[i]));
+    }
+  }
+}
+
+static int MLFQTick(pcb_t *current)
+{
+  if (++mlfq_ticks_since_boost >= MLFQ_BOOST_PERIOD)
+  {
+    mlfq_ticks_since_boost = 0;
+    MLFQBoost();
+    return 1;
+  }
+
+  current->sched_ticks++;
+  if (current->sched_ticks >= MLFQQuantum(current->sched_level))
+  {
+    return 1;
+  }
+
+  // A process that became ready at a higher level takes over at the next tick
+  for (int i = 0; i < current->sched_level; i++)
+  {
+    if (!pcb_queue_is_empty(mlfq_queues[i]))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/*---------------------------------
+ * Fixed Priority
+ *--------------------------------*/
+static pcb_queue_t *prio_queues[PRIO_LEVELS]; // One ready queue per priority, 0 runs first
+static unsigned int prio_bitmap = 0;          // Bit i is set while prio_queues[i] is not empty
+
+static void PrioInit(void)
+{
+  for (int i = 0; i < PRIO_LEVELS; i++)
+  {
+    prio_queues[i] = pcb_queue_create();
+    if (prio_queues[i] == NULL)
+    {
+      TracePrintf(0, "PrioInit: Failed to create ready queue %d\n", i);
+      Halt();
+    }
+  }
+}
+
+static void PrioMakeReady(pcb_t *pcb, sched_reason_t reason)
+{
+  pcb_enqueue(prio_queues[pcb->priority], pcb);
+  prio_bitmap |= 1u << pcb->priority;
+}
+
+static pcb_t *PrioPickNext(void)
+{
+  if (prio_bitmap == 0)
+  {
+    return NULL;
+  }
+
+  // The lowest set bit is the highest non-empty priority
+  int priority = __builtin_ctz(prio_bitmap);
+  pcb_t *pcb = pcb_dequeue(prio_queues[priority]);
+  if (pcb_queue_is_empty(prio_queues[priority]))
+  {
+    prio_bitmap &= ~(1u << priority);
+  }
+  return pcb;
+}
+
+static void PrioRemove(pcb_t *pcb)
+{
+  pcb_remove(prio_queues[pcb->priority], pcb);
+  if (pcb_queue_is_empty(prio_queues[pcb->priority]))
+  {
+    prio_bitmap &= ~(1u << pcb->priority);
+  }
+}
+
+static int PrioHasReady(void)
+{
+  return prio_bitmap != 0;
+}
+
+static int PrioTick(pcb_t *current)
+{
+  // A higher priority preempts at once; equals take turns each quantum; anything lower waits
+  unsigned int higher = (1u << current->priority) - 1;
+  if (prio_bitmap & higher)
+  {
+    return 1;
+  }
+  return current->slice_ticks >= SliceFor(current) && (prio_bitmap & (1u << current->priority));
+}
+
+/*---------------------------------
+ * Completely Fair (virtual runtime)
+ *--------------------------------*/
+static pcb_t **cfs_heap;               // Min-heap of runnable processes keyed on vruntime
+static int cfs_heap_size = 0;          // Number of processes in the heap
+static int cfs_heap_capacity = 0;      // Allocated slots in the heap
+static unsigned long cfs_min_vruntime; // Never decreases; new and waking processes are placed relative to it
+static int cfs_weights[PRIO_LEVELS];   // Weight per priority, about 25% more per level up
+
+static void CFSInit(void)
+{
+  cfs_heap = (pcb_t **)malloc(CFS_INITIAL_CAPACITY * sizeof(pcb_t *));
+  if (cfs_heap == NULL)
+  {
+    TracePrintf(0, "CFSInit: Failed to allocate runnable heap\n");
+    Halt();
+  }
+  cfs_heap_capacity = CFS_INITIAL_CAPACITY;
+
+  cfs_weights[PRIO_DEFAULT] = CFS_NICE_0_WEIGHT;
+  for (int i = PRIO_DEFAULT - 1; i >= 0; i--)
+  {
+    cfs_weights[i] = cfs_weights[i + 1] * 5 / 4;
+  }
+  for (int i = PRIO_DEFAULT + 1; i < PRIO_LEVELS; i++)
+  {
+    cfs_weights[i] = cfs_weights[i - 1] * 4 / 5;
+  }
+}
+
+static void CFSSwap(int a, int b)
+{
+  pcb_t *tmp = cfs_heap[a];
+  cfs_heap[a] = cfs_heap[b];
+  cfs_heap[b] = tmp;
+  cfs_heap[a]->heap_index = a;
+  cfs_heap[b]->heap_index = b;
+}
+
+static void CFSSiftUp(int i)
+{
+  while (i > 0 && cfs_heap[(i - 1) / 2]->vruntime > cfs_heap[i]->vruntime)
+  {
+    CFSSwap(i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+}
+
+static void CFSSiftDown(int i)
+{
+  while (1)
+  {
+    int smallest = i;
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+    if (left < cfs_heap_size && cfs_heap[left]->vruntime < cfs_heap[smallest]->vruntime)
+    {
+      smallest = left;
+    }
+    if (right < cfs_heap_size && cfs_heap[right]->vruntime < cfs_heap[smallest]->vruntime)
+    {
+      smallest = right;
+    }
+    if (smallest == i)
+    {
+      return;
+    }
+    CFSSwap(i, smallest);
+    i = smallest;
+  }
+}
+
+static void CFSMakeReady(pcb_t *pcb, sched_reason_t reason)
+{
+  if (reason == SCHED_NEW)
+  {
+    pcb->vruntime = cfs_min_vruntime;
+  }
+  else if (reason == SCHED_WOKEN)
+  {
+    // A long sleeper gets a bounded head start instead of all the time it missed; batch work gets none
+    unsigned long credit = (pcb->sched_hint == SCHED_HINT_BATCH) ? 0 : CFS_WAKE_CREDIT;
+    if (pcb->vruntime + credit < cfs_min_vruntime)
+    {
+      pcb->vruntime = cfs_min_vruntime - credit;
+    }
+  }
+  else if (reason == SCHED_YIELDED && cfs_heap_size > 0 && pcb->vruntime <= cfs_heap[0]->vruntime)
+  {
+    // Step behind the current leftmost process so it runs first
+    pcb->vruntime = cfs_heap[0]->vruntime + 1;
+  }
+
+  if (cfs_heap_size == cfs_heap_capacity)
+  {
+    pcb_t **bigger = (pcb_t **)realloc(cfs_heap, 2 * cfs_heap_capacity * sizeof(pcb_t *));
+    if (bigger == NULL)
+    {
+      TracePrintf(0, "CFSMakeReady: Failed to grow runnable heap\n");
+      Halt();
+    }
+    cfs_heap = bigger;
+    cfs_heap_capacity *= 2;
+  }
+
+  pcb->heap_index = cfs_heap_size;
+  cfs_heap[cfs_heap_size++] = pcb;
+  CFSSiftUp(pcb->heap_index);
+}
+
+static void CFSRemove(pcb_t *pcb)
+{
+  int i = pcb->heap_index;
+  if (i < 0)
+  {
+    return;
+  }
+
+  cfs_heap_size--;
+  if (i != cfs_heap_size)
+  {
+    cfs_heap[i] = cfs_heap[cfs_heap_size];
+    cfs_heap[i]->heap_index = i;
+    CFSSiftDown(i);
+    CFSSiftUp(i);
+  }
+  pcb->heap_index = -1;
+}
+
+static pcb_t *CFSPickNext(void)
+{
+  if (cfs_heap_size == 0)
+  {
+    return NULL;
+  }
+  pcb_t *pcb = cfs_heap[0];
+  CFSRemove(pcb);
+  return pcb;
+}
+
+static int CFSHasReady(void)
+{
+  return cfs_heap_size > 0;
+}
+
+static int CFSTick(pcb_t *current)
+{
+  // Heavier processes age more slowly, so they get a larger share of the CPU
+  current->vruntime += (unsigned long)CFS_NICE_0_WEIGHT * CFS_NICE_0_WEIGHT / cfs_weights[current->priority];
+
+  unsigned long min_vruntime = current->vruntime;
+  if (cfs_heap_size > 0 && cfs_heap[0]->vruntime < min_vruntime)
+  {
+    min_vruntime = cfs_heap[0]->vruntime;
+  }
+  if (min_vruntime > cfs_min_vruntime)
+  {
+    cfs_min_vruntime = min_vruntime;
+  }
+
+  return cfs_heap_size > 0 && current->vruntime > cfs_heap[0]->vruntime + (unsigned long)CFS_GRANULARITY * SliceFor(current);
+}
+
+/*---------------------------------
+ * Stride (proportional share between groups)
+ *--------------------------------*/
+
+/**
+ * Scheduling Group
+ *
+ * Processes in a group share its tickets, so forking more workers does not
+ * buy a tenant more of the CPU.
+ */
+typedef struct sched_group
+{
+  int in_use;           // Whether this group exists
+  int tickets;          // Share of the CPU relative to other groups
+  unsigned long stride; // STRIDE_ONE / tickets: pass added per tick used
+  unsigned long pass;   // Virtual time; the ready group with the lowest pass runs next
+  int ticks;            // Clock ticks consumed by the group's processes
+  pcb_queue_t *ready;   // The group's ready processes, run round robin
+} sched_group_t;
+
+static sched_group_t groups[MAX_SCHED_GROUPS];
+static unsigned long stride_global_pass = 0; // Pass of the group picked most recently
+
+static void StrideInit(void)
+{
+  for (int i = 0; i < MAX_SCHED_GROUPS; i++)
+  {
+    groups[i].ready = pcb_queue_create();
+    if (groups[i].ready == NULL)
+    {
+      TracePrintf(0, "StrideInit: Failed to create ready queue for group %d\n", i);
+      Halt();
+    }
+  }
+
+  groups[0].in_use = 1;
+  groups[0].tickets = STRIDE_DEFAULT_TICKETS;
+  groups[0].stride = STRIDE_ONE / STRIDE_DEFAULT_TICKETS;
+}
+
+static void StrideMakeReady(pcb_t *pcb, sched_reason_t reason)
+{
+  sched_group_t *group = &groups[pcb->sched_group];
+
+  // A group that sat idle rejoins at the current pass instead of cashing in the time it missed
+  if (pcb_queue_is_empty(group->ready) && group->pass < stride_global_pass)
+  {
+    group->pass = stride_global_pass;
+  }
+  pcb_enqueue(group->ready, pcb);
+}
+
+static pcb_t *StridePickNext(void)
+{
+  sched_group_t *best = NULL;
+  for (int i = 0; i < MAX_SCHED_GROUPS; i++)
+  {
+    if (groups[i].in_use && !pcb_queue_is_empty(groups[i].ready) &&
+        (best == NULL || groups[i].pass < best->pass))
+    {
+      best = &groups[i];
+    }
+  }
+
+  if (best == NULL)
+  {
+    return NULL;
+  }
+  stride_global_pass = best->pass;
+  return pcb_dequeue(best->ready);
+}
+
+static void StrideRemove(pcb_t *pcb)
+{
+  pcb_remove(groups[pcb->sched_group].ready, pcb);
+}
+
+static int StrideHasReady(void)
+{
+  for (int i = 0; i < MAX_SCHED_GROUPS; i++)
+  {
+    if (groups[i].in_use && !pcb_queue_is_empty(groups[i].ready))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int StrideTick(pcb_t *current)
+{
+  groups[current->sched_group].pass += groups[current->sched_group].stride;
+  return current->slice_ticks >= SliceFor(current);
+}
+
+/*---------------------------------
+ * Real-Time (earliest deadline first)
+ *--------------------------------*/
+static pcb_queue_t *rt_queue;  // Ready real-time processes, sorted by deadline
+static int rt_utilization = 0; // Sum of budget / period over admitted processes, in RT_UTIL_SCALE units
+
+static int IsRealTime(pcb_t *pcb)
+{
+  return pcb->rt_period > 0;
+}
+
+// Utilization of a reservation, rounded up so admission never undercounts it
+static int RTShare(int budget, int period)
+{
+  return (budget * RT_UTIL_SCALE + period - 1) / period;
+}
+
+// Starts the period after the current one, counting a miss if the process still had work due
+static void RTNextPeriod(pcb_t *pcb, int missed)
+{
+  if (missed)
+  {
+    pcb->rt_misses++;
+    TracePrintf(1, "RTNextPeriod: pid %d missed its deadline at tick %u\n", pcb->pid, pcb->rt_deadline);
+  }
+  pcb->rt_deadline += pcb->rt_period;
+  pcb->rt_remaining = pcb->rt_budget;
+}
+
+// Timer callback: a throttled or waiting process's next period has begun
+static void RTReplenish(pcb_t *pcb)
+{
+  RTNextPeriod(pcb, 0);
+  MakeReady(pcb, SCHED_WOKEN);
+}
+
+static void RTMakeReady(pcb_t *pcb)
+{
+  // Out of budget for this period: sleep until the next one starts
+  if (pcb->rt_remaining <= 0)
+  {
+    pcb->state = PCB_STATE_BLOCKED;
+    StartTimer(pcb, pcb->rt_deadline - CurrentTick(), RTReplenish);
+    TracePrintf(2, "RTMakeReady: pid %d throttled until tick %u\n", pcb->pid, pcb->rt_deadline);
+    return;
+  }
+
+  pcb_t *after = rt_queue->head;
+  while (after != NULL && after->rt_deadline <= pcb->rt_deadline)
+  {
+    after = after->next;
+  }
+  pcb_insert_before(rt_queue, after, pcb);
+}
+
+static pcb_t *RTPickNext(void)
+{
+  while (!pcb_queue_is_empty(rt_queue))
+  {
+    pcb_t *pcb = pcb_dequeue(rt_queue);
+    if (CurrentTick() < pcb->rt_deadline)
+    {
+      return pcb;
+    }
+
+    // Its deadline passed while it waited; charge the miss and run it in its next period
+    RTNextPeriod(pcb, 1);
+    RTMakeReady(pcb);
+  }
+  return NULL;
+}
+
+static int RTTick(pcb_t *current)
+{
+  current->rt_remaining--;
+  if (CurrentTick() >= current->rt_deadline)
+  {
+    RTNextPeriod(current, current->rt_remaining > 0);
+  }
+  if (current->rt_remaining <= 0)
+  {
+    return 1;
+  }
+
+  // An earlier deadline takes over
+  return rt_queue->head != NULL && rt_queue->head->rt_deadline < current->rt_deadline;
+}
+
+int SetRealTime(pcb_t *pcb, int period, int budget)
+{
+  if (period < 0 || budget < 0 || (period > 0 && (budget == 0 || budget > period)))
+  {
+    return ERROR;
+  }
+
+  int old_share = IsRealTime(pcb) ? RTShare(pcb->rt_budget, pcb->rt_period) : 0;
+  int new_share = (period > 0) ? RTShare(budget, period) : 0;
+  if (rt_utilization - old_share + new_share > RT_UTIL_MAX)
+  {
+    TracePrintf(0, "SetRealTime: Refusing pid %d, utilization would reach %d/%d\n",
+                pcb->pid, rt_utilization - old_share + new_share, RT_UTIL_SCALE);
+    return ERROR;
+  }
+
+  int was_ready = (pcb->state == PCB_STATE_READY);
+  if (was_ready)
+  {
+    SchedRemove(pcb);
+  }
+
+  rt_utilization += new_share - old_share;
+  pcb->rt_period = period;
+  pcb->rt_budget = budget;
+  pcb->rt_remaining = budget;
+  pcb->rt_deadline = CurrentTick() + period;
+
+  if (was_ready)
+  {
+    MakeReady(pcb, SCHED_REQUEUED);
+  }
+  return SUCCESS;
+}
+
+void LeaveRealTime(pcb_t *pcb)
+{
+  if (IsRealTime(pcb))
+  {
+    rt_utilization -= RTShare(pcb->rt_budget, pcb->rt_period);
+    pcb->rt_period = 0;
+    pcb->rt_budget = 0;
+  }
+}
+
+int WaitNextPeriod(pcb_t *pcb)
+{
+  if (!IsRealTime(pcb))
+  {
+    return ERROR;
+  }
+
+  // Finished after the deadline: count it and catch up without sleeping
+  if (CurrentTick() >= pcb->rt_deadline)
+  {
+    RTNextPeriod(pcb, 1);
+    while (CurrentTick() >= pcb->rt_deadline)
+    {
+      pcb->rt_deadline += pcb->rt_period;
+    }
+    return SUCCESS;
+  }
+
+  pcb->state = PCB_STATE_BLOCKED;
+  StartTimer(pcb, pcb->rt_deadline - CurrentTick(), RTReplenish);
+  return SUCCESS;
+}
+
+/*---------------------------------
+ * Policy Selection
+ *--------------------------------*/
+static sched_policy_t policies[] = {
+    {"rr", RRInit, RRMakeReady, RRPickNext, RRHasReady, RRRemove, RRTick},
+    {"mlfq", MLFQInit, MLFQMakeReady, MLFQPickNext, MLFQHasReady, MLFQRemove, MLFQTick},
+    {"prio", PrioInit, PrioMakeReady, PrioPickNext, PrioHasReady, PrioRemove, PrioTick},
+    {"cfs", CFSInit, CFSMakeReady, CFSPickNext, CFSHasReady, CFSRemove, CFSTick},
+    {"stride", StrideInit, StrideMakeReady, StridePickNext, StrideHasReady, StrideRemove, StrideTick},
+};
+
+#define NUM_POLICIES (sizeof(policies) / sizeof(policies[0]))
+
+static sched_policy_t *policy = &policies[0]; // The active policy
+static int handoff_enabled = 0;               // Whether wakers hand the CPU to the woken process
+static pcb_queue_t *boost_queue;              // Terminal readers woken by input, run before the policy
+
+void InitScheduler(void)
+{
+  for (int i = 0; i < NUM_POLICIES; i++)
+  {
+    policies[i].init();
+  }
+
+  rt_queue = pcb_queue_create();
+  if (rt_queue == NULL)
+  {
+    TracePrintf(0, "InitScheduler: Failed to create real-time queue\n");
+    Halt();
+  }
+
+  boost_queue = pcb_queue_create();
+  if (boost_queue == NULL)
+  {
+    TracePrintf(0, "InitScheduler: Failed to create boost queue\n");
+    Halt();
+  }
+}
+
+int SetSchedPolicy(char *name)
+{
+  for (int i = 0; i < NUM_POLICIES; i++)
+  {
+    if (strcmp(policies[i].name, name) == 0)
+    {
+      policy = &policies[i];
+      TracePrintf(0, "SetSchedPolicy: Using %s scheduler\n", policy->name);
+      return SUCCESS;
+    }
+  }
+  TracePrintf(0, "SetSchedPolicy: Unknown scheduler %s\n", name);
+  return ERROR;
+}
+
+/*---------------------------------
+ * Scheduler Entry Points
+ *--------------------------------*/
+// Rate-limits the terminal boost so a process cannot stay ahead by feeding itself input
+static int TakeTtyBoost(pcb_t *pcb)
+{
+  if (pcb->sched_hint == SCHED_HINT_BATCH)
+  {
+    return 0;
+  }
+  if (CurrentTick() - pcb->boost_window_start >= TTY_BOOST_WINDOW)
+  {
+    pcb->boost_window_start = CurrentTick();
+    pcb->boosts_used = 0;
+  }
+  if (pcb->boosts_used >= TTY_BOOST_MAX)
+  {
+    return 0;
+  }
+  pcb->boosts_used++;
+  return 1;
+}
+
+void MakeReady(pcb_t *pcb, sched_reason_t reason)
+{
+  pcb->state = PCB_STATE_READY;
+  if (IsRealTime(pcb))
+  {
+    RTMakeReady(pcb);
+  }
+  else if (reason == SCHED_TTY_INPUT && TakeTtyBoost(pcb))
+  {
+    // Let the policy do its wake-up bookkeeping, then jump the queue
+    policy->make_ready(pcb, SCHED_WOKEN);
+    policy->remove(pcb);
+    pcb_enqueue(boost_queue, pcb);
+    TracePrintf(2, "MakeReady: pid %d boosted for terminal input\n", pcb->pid);
+  }
+  else
+  {
+    policy->make_ready(pcb, reason == SCHED_TTY_INPUT ? SCHED_WOKEN : reason);
+  }
+}
+
+void SchedRemove(pcb_t *pcb)
+{
+  if (IsRealTime(pcb))
+  {
+    pcb_remove(rt_queue, pcb);
+  }
+  else if (pcb->queue == boost_queue)
+  {
+    pcb_remove(boost_queue, pcb);
+  }
+  else
+  {
+    policy->remove(pcb);
+  }
+}
+
+void SetPriority(pcb_t *pcb, int priority)
+{
+  if (pcb->state == PCB_STATE_READY)
+  {
+    SchedRemove(pcb);
+    pcb->priority = priority;
+    MakeReady(pcb, SCHED_REQUEUED);
+  }
+  else
+  {
+    pcb->priority = priority;
+  }
+}
+
+void SetHandoffMode(int enabled)
+{
+  handoff_enabled = enabled;
+  TracePrintf(0, "SetHandoffMode: Directed handoff %s\n", enabled ? "on" : "off");
+}
+
+void DirectedYield(pcb_t *target)
+{
+  pcb_t *current = GetCurrentProcess();
+  if (!handoff_enabled || target == NULL || target->state != PCB_STATE_READY ||
+      current == idle_pcb || IsRealTime(current) || IsRealTime(target))
+  {
+    return;
+  }
+
+  // The target runs out the rest of the caller's slice, so a ping-pong pair still yields each quantum
+  int remaining = SliceFor(current) - current->slice_ticks;
+  target->slice_ticks = SliceFor(target) - ((remaining > 0) ? remaining : 0);
+  if (target->slice_ticks < 0)
+  {
+    target->slice_ticks = 0;
+  }
+
+  TracePrintf(2, "DirectedYield: pid %d hands the CPU to pid %d\n", current->pid, target->pid);
+  SchedRemove(target);
+  MakeReady(current, SCHED_REQUEUED);
+  int rc = KernelContextSwitch(KCSwitch, current, target);
+  if (rc == -1)
+  {
+    TracePrintf(0, "DirectedYield: KernelContextSwitch failed\n");
+    Halt();
+  }
+}
+
+int CreateSchedGroup(int tickets)
+{
+  if (tickets < 1 || tickets > STRIDE_MAX_TICKETS)
+  {
+    return ERROR;
+  }
+
+  for (int i = 1; i < MAX_SCHED_GROUPS; i++)
+  {
+    if (!groups[i].in_use)
+    {
+      groups[i].in_use = 1;
+      groups[i].tickets = tickets;
+      groups[i].stride = STRIDE_ONE / tickets;
+      groups[i].pass = stride_global_pass;
+      groups[i].ticks = 0;
+      TracePrintf(1, "CreateSchedGroup: Group %d has %d tickets\n", i, tickets);
+      return i;
+    }
+  }
+  TracePrintf(0, "CreateSchedGroup: No free scheduling groups\n");
+  return ERROR;
+}
+
+int DestroySchedGroup(int group)
+{
+  if (group <= 0 || group >= MAX_SCHED_GROUPS || !groups[group].in_use)
+  {
+    return ERROR;
+  }
+
+  // Exited processes never run again, so only live members keep a group alive
+  for (pcb_t *pcb = NextPCB(NULL); pcb != NULL; pcb = NextPCB(pcb))
+  {
+    if (pcb->sched_group == group && pcb->state != PCB_STATE_DEFUNCT)
+    {
+      TracePrintf(0, "DestroySchedGroup: Process %d is still in group %d\n", pcb->pid, group);
+      return ERROR;
+    }
+  }
+
+  groups[group].in_use = 0;
+  TracePrintf(1, "DestroySchedGroup: Group %d destroyed\n", group);
+  return SUCCESS;
+}
+
+int SetSchedGroup(pcb_t *pcb, int group)
+{
+  if (group < 0 || group >= MAX_SCHED_GROUPS || !groups[group].in_use)
+  {
+    return ERROR;
+  }
+
+  if (pcb->state == PCB_STATE_READY)
+  {
+    SchedRemove(pcb);
+    pcb->sched_group = group;
+    MakeReady(pcb, SCHED_REQUEUED);
+  }
+  else
+  {
+    pcb->sched_group = group;
+  }
+  return SUCCESS;
+}
+
+int GetSchedGroupTicks(int group)
+{
+  if (group < 0 || group >= MAX_SCHED_GROUPS || !groups[group].in_use)
+  {
+    return ERROR;
+  }
+  return groups[group].ticks;
+}
+
+pcb_t *PickNextProcess(void)
+{
+  // Real-time processes always run ahead of the normal policy, then boosted terminal readers
+  pcb_t *next = RTPickNext();
+  if (next == NULL && !pcb_queue_is_empty(boost_queue))
+  {
+    next = pcb_dequeue(boost_queue);
+  }
+  if (next == NULL)
+  {
+    next = policy->pick_next();
+  }
+  if (next == NULL)
+  {
+    return idle_pcb;
+  }
+
+  // A fresh quantum starts each time a process is dispatched
+  next->slice_ticks = 0;
+  return next;
+}
+
+void YieldProcess(pcb_t *pcb)
+{
+  if (!SchedHasReady())
+  {
+    return;
+  }
+
+  MakeReady(pcb, SCHED_YIELDED);
+  pcb_t *next = PickNextProcess();
+  int rc = KernelContextSwitch(KCSwitch, pcb, next);
+  if (rc == -1)
+  {
+    TracePrintf(0, "YieldProcess: KernelContextSwitch failed\n");
+    Halt();
+  }
+}
+
+int SchedHasReady(void)
+{
+  return !pcb_queue_is_empty(rt_queue) || !pcb_queue_is_empty(boost_queue) || policy->has_ready();
+}
+
+void SetQuantum(int ticks)
+{
+  sched_quantum = ticks;
+  TracePrintf(0, "SetQuantum: Quantum is %d ticks\n", sched_quantum);
+}
+
+int GetQuantum(void)
+{
+  return sched_quantum;
+}
+
+int SchedTick(pcb_t *current)
+{
+  groups[current->sched_group].ticks++;
+  current->slice_ticks++;
+
+  int preempt;
+  if (IsRealTime(current))
+  {
+    preempt = RTTick(current);
+
+    // Out of budget: it must leave the CPU even if only idle can run
+    if (current->rt_remaining <= 0)
+    {
+      return 1;
+    }
+  }
+  else
+  {
+    // A ready real-time process preempts any normal one; a boosted reader waits at most one quantum
+    preempt = !pcb_queue_is_empty(rt_queue) ||
+              (!pcb_queue_is_empty(boost_queue) && current->slice_ticks >= sched_quantum) ||
+              policy->tick(current);
+  }
+
+  // Nothing else is ready, so switching would just bring us back
+  return preempt && SchedHasReady();
+}
@@ -0,0 +1,281 @@
+#ifndef _SCHEDULER_H
+#define _SCHEDULER_H
+
+#include "process.h"
+
+#define SCHED_DEFAULT_QUANTUM 1 // Clock ticks a process runs before another ready process gets the CPU
+
+#define MLFQ_LEVELS 4         // Number of MLFQ ready queues; the top level's quantum is the base quantum
+#define MLFQ_BOOST_PERIOD 100 // Clock ticks between priority boosts
+
+#define PRIO_LEVELS 32  // Number of fixed priorities, one bit each in the ready bitmap
+#define PRIO_DEFAULT 16 // Priority of init; children inherit their parent's
+
+#define CFS_NICE_0_WEIGHT 1024  // Weight of a process at PRIO_DEFAULT
+#define CFS_GRANULARITY 1024    // Virtual runtime lead per quantum tick the running process may build before preemption
+#define CFS_WAKE_CREDIT 4096    // Most virtual runtime a waking process can be placed behind the minimum
+#define CFS_INITIAL_CAPACITY 16 // Initial size of the runnable heap
+
+#define MAX_SCHED_GROUPS 16        // Scheduling groups, including the default group 0
+#define STRIDE_DEFAULT_TICKETS 100 // Tickets of the default group
+#define STRIDE_MAX_TICKETS 10000   // Most tickets a group can hold
+#define STRIDE_ONE (1 << 20)       // Stride of a group holding a single ticket
+
+#define RT_UTIL_SCALE 10000 // Fixed-point scale for real-time utilization, 1.0 in these units
+#define RT_UTIL_MAX 9000    // Most total real-time utilization admitted, leaving normal processes a share
+
+#define TTY_BOOST_MAX 4     // Boosted wake-ups a process may get per window
+#define TTY_BOOST_WINDOW 20 // Length of the boost rate window in clock ticks
+
+/**
+ * Scheduling Hints
+ *
+ * How a process describes its own workload; set with the SchedHint syscall.
+ */
+typedef enum sched_hint
+{
+  SCHED_HINT_NORMAL,      // No preference
+  SCHED_HINT_BATCH,       // Throughput over latency: longer slices, no wake-up favours
+  SCHED_HINT_INTERACTIVE, // Latency over throughput: kept near the front
+  NUM_SCHED_HINTS
+} sched_hint_t;
+
+/**
+ * Ready Reasons
+ *
+ * Why a process is being made ready; policies use this to adjust its priority.
+ */
+typedef enum sched_reason
+{
+  SCHED_NEW,       // Newly created by fork or at boot
+  SCHED_PREEMPTED, // Taken off the CPU by the clock
+  SCHED_WOKEN,     // Was blocked and is now runnable again
+  SCHED_REQUEUED,  // Was already ready and is being reinserted after a priority change
+  SCHED_YIELDED,   // Gave up the CPU voluntarily with Yield
+  SCHED_TTY_INPUT, // Was blocked in TtyRead and terminal input arrived
+} sched_reason_t;
+
+/**
+ * Scheduling Policy
+ *
+ * Operations a scheduling policy provides. Every other part of the kernel
+ * goes through MakeReady, PickNextProcess and SchedTick and never touches
+ * the policy's ready structures directly. Real-time processes and boosted
+ * terminal readers are queued ahead of the policy and run first.
+ */
+typedef struct sched_policy
+{
+  char *name;                                     // Name used to select the policy at boot
+  void (*init)(void);                             // Allocate the policy's ready structures
+  void (*make_ready)(pcb_t *pcb, sched_reason_t); // Add a runnable process
+  pcb_t *(*pick_next)(void);                      // Remove and return the next process, NULL if none
+  int (*has_ready)(void);                         // Whether any process is ready
+  void (*remove)(pcb_t *pcb);                     // Take a ready process out of the ready structures
+  int (*tick)(pcb_t *current);                    // Charge a clock tick, return 1 to preempt
+} sched_policy_t;
+
+/**
+ * InitScheduler - Initialize every scheduling policy
+ *
+ * Round robin is active until SetSchedPolicy selects another.
+ *
+ * Note: Halts the system if memory allocation fails
+ */
+void InitScheduler(void);
+
+/**
+ * SetSchedPolicy - Select the active scheduling policy by name
+ *
+ * Must be called before any process is made ready.
+ *
+ * @param name - "rr", "mlfq", "prio", "cfs" or "stride"
+ *
+ * @return SUCCESS on success, ERROR if no policy has that name
+ */
+int SetSchedPolicy(char *name);
+
+/**
+ * MakeReady - Hand a runnable process to the scheduler
+ *
+ * A process woken with SCHED_TTY_INPUT jumps ahead of the policy's ready
+ * processes, at most TTY_BOOST_MAX times per TTY_BOOST_WINDOW ticks.
+ *
+ * @param pcb - The process, which must not be on any queue
+ * @param reason - Why the process is runnable
+ */
+void MakeReady(pcb_t *pcb, sched_reason_t reason);
+
+/**
+ * SchedRemove - Take a ready process out of the scheduler
+ *
+ * @param pcb - A process in the PCB_STATE_READY state
+ */
+void SchedRemove(pcb_t *pcb);
+
+/**
+ * SetPriority - Change the priority a process is scheduled at
+ *
+ * Moves the process to its new level at once if it is ready.
+ *
+ * @param pcb - The process
+ * @param priority - New priority, 0 (highest) to PRIO_LEVELS - 1
+ */
+void SetPriority(pcb_t *pcb, int priority);
+
+/**
+ * CreateSchedGroup - Create a scheduling group
+ *
+ * @param tickets - The group's share of the CPU relative to other groups, 1 to STRIDE_MAX_TICKETS
+ *
+ * @return The new group's ID, ERROR if the ticket count is invalid or no group is free
+ */
+int CreateSchedGroup(int tickets);
+
+/**
+ * DestroySchedGroup - Destroy an empty scheduling group so its ID can be reused
+ *
+ * @param group - ID of an existing group other than the default group 0
+ *
+ * @return SUCCESS on success, ERROR if the group does not exist, is group 0
+ *         or still holds a live process
+ */
+int DestroySchedGroup(int group);
+
+/**
+ * SetSchedGroup - Move a process to another scheduling group
+ *
+ * Moves the process to the new group's ready queue at once if it is ready.
+ *
+ * @param pcb - The process
+ * @param group - ID of an existing group
+ *
+ * @return SUCCESS on success, ERROR if the group does not exist
+ */
+int SetSchedGroup(pcb_t *pcb, int group);
+
+/**
+ * GetSchedGroupTicks - Returns the clock ticks consumed by a group's processes
+ *
+ * Ticks are counted under every policy, not just stride.
+ *
+ * @param group - ID of an existing group
+ *
+ * @return Ticks consumed since the group was created, ERROR if the group does not exist
+ */
+int GetSchedGroupTicks(int group);
+
+/**
+ * SetRealTime - Put a process in the real-time class, change its reservation or take it out
+ *
+ * Real-time processes run by earliest deadline ahead of every normal process.
+ * Each period the process may run for budget ticks; once the budget is used
+ * it is throttled until the next period. Admission control refuses any
+ * reservation that would push total utilization (sum of budget / period,
+ * each rounded up) above RT_UTIL_MAX, so real-time work cannot starve
+ * normal processes.
+ *
+ * @param pcb - The process
+ * @param period - Period in clock ticks, 0 to leave the real-time class
+ * @param budget - Ticks of CPU per period, 1 to period
+ *
+ * @return SUCCESS on success, ERROR if the values are invalid or admission fails
+ */
+int SetRealTime(pcb_t *pcb, int period, int budget);
+
+/**
+ * LeaveRealTime - Take an exiting process out of the real-time class
+ *
+ * Returns its utilization to the admission pool.
+ *
+ * @param pcb - The process
+ */
+void LeaveRealTime(pcb_t *pcb);
+
+/**
+ * WaitNextPeriod - Block a real-time process until its next period starts
+ *
+ * The caller must switch away after this returns if it set the process
+ * blocked. A process already past its deadline has the miss counted and
+ * continues at once in the current period.
+ *
+ * @param pcb - The running real-time process
+ *
+ * @return SUCCESS on success, ERROR if the process is not real-time
+ */
+int WaitNextPeriod(pcb_t *pcb);
+
+/**
+ * SetHandoffMode - Turn directed handoff on wake-up on or off
+ *
+ * @param enabled - Nonzero to let wakers give the CPU straight to the woken process
+ */
+void SetHandoffMode(int enabled);
+
+/**
+ * DirectedYield - Give the CPU straight to a process the caller just woke
+ *
+ * In handoff mode the caller goes back to the ready structures and the
+ * target runs at once, so a request/response exchange costs one context
+ * switch instead of a trip around the run queue. The target only gets what
+ * is left of the caller's time slice. Does nothing when handoff
+ * mode is off, the target is NULL or no longer ready, the caller is idle,
+ * or either process is real-time (EDF order wins over handoff).
+ *
+ * @param target - The process the caller made ready, or NULL
+ */
+void DirectedYield(pcb_t *target);
+
+/**
+ * PickNextProcess - Remove and return the process that should run next
+ *
+ * @return The chosen process, or the idle process if nothing is ready
+ */
+pcb_t *PickNextProcess(void);
+
+/**
+ * YieldProcess - Move the running process behind every other ready process
+ *
+ * Returns at once without switching if nothing else is ready.
+ *
+ * @param pcb - The running process
+ */
+void YieldProcess(pcb_t *pcb);
+
+/**
+ * SchedHasReady - Check whether any process is waiting for the CPU
+ *
+ * @return 1 if a process is ready, 0 if only the running process (or idle) could run
+ */
+int SchedHasReady(void);
+
+/**
+ * SetQuantum - Set the base time quantum
+ *
+ * Round robin, prio and stride switch after this many ticks; MLFQ uses it
+ * for its top level and CFS scales its preemption granularity by it.
+ *
+ * @param ticks - Quantum in clock ticks, at least 1
+ */
+void SetQuantum(int ticks);
+
+/**
+ * GetQuantum - Returns the base time quantum in clock ticks
+ *
+ * @return The quantum
+ */
+int GetQuantum(void);
+
+/**
+ * SchedTick - Charge a clock tick to the running process
+ *
+ * Only asks for a context switch when the policy wants to preempt and some
+ * other process is ready, so a lone CPU-bound process is not switched to
+ * itself every tick.
+ *
+ * @param current - The running process, never the idle process
+ *
+ * @return 1 if the process should be preempted, 0 if it keeps the CPU
+ */
+int SchedTick(pcb_t *current);
+
+#endif // _SCHEDULER_H
@@ -6,43 +6,352 @@
 #include "yalnix.h"
 #include "syscalls.h"
 #include "process.h"
+#include "merge.h"
+#include "scheduler.h"
+#include "timer.h"
 
-lock_list_t *global_locks;
-cond_list_t *global_condvars;
-pipe_list_t *global_pipes;
-int next_sync_id = 1;
+static sync_slot_t *sync_slots; // Object table indexed by the slot bits of an ID
+static int sync_capacity;       // Number of entries in sync_slots
+static int sync_free_head = -1; // First free slot, -1 if the table is full
+
+static int lock_profiling = 0; // Whether lock operations update their profile counters
+
+// Credits a reclaimed object back to the process that created it, if it is still around
+static void UnchargeSyncObject(int creator_pid)
+{
+  pcb_t *creator = FindPCB(creator_pid);
+  if (creator != NULL)
+  {
+    creator->num_sync_objects--;
+  }
+}
 
 void InitSyncLists()
 {
-  global_locks = (lock_list_t *)malloc(sizeof(lock_list_t));
-  if (global_locks == NULL)
+  sync_slots = (sync_slot_t *)malloc(SYNC_INITIAL_SLOTS * sizeof(sync_slot_t));
+  if (sync_slots == NULL)
   {
-    TracePrintf(0, "Failed to allocate memory for global_locks\n");
+    TracePrintf(0, "Failed to allocate memory for the sync object table\n");
     Halt();
   }
-  global_locks->head = NULL;
-  global_locks->tail = NULL;
-  global_locks->size = 0;
+  sync_capacity = SYNC_INITIAL_SLOTS;
 
-  global_condvars = (cond_list_t *)malloc(sizeof(cond_list_t));
-  if (global_condvars == NULL)
+  for (int i = 0; i < sync_capacity; i++)
   {
-    TracePrintf(0, "Failed to allocate memory for global_condvars\n");
-    Halt();
+    sync_slots[i].type = 0;
+    sync_slots[i].generation = 0;
+    sync_slots[i].object = NULL;
+    sync_slots[i].next_free = (i + 1 < sync_capacity) ? i + 1 : -1;
+    sync_slots[i].refs = 0;
+    sync_slots[i].last_user_pid = 0;
+  }
+  sync_free_head = 0;
+}
+
+// Doubles the object table and threads the new slots onto the free list
+static int GrowSyncSlots(void)
+{
+  if (sync_capacity >= SYNC_MAX_SLOTS)
+  {
+    return ERROR;
   }
-  global_condvars->head = NULL;
-  global_condvars->tail = NULL;
-  global_condvars->size = 0;
 
-  global_pipes = (pipe_list_t *)malloc(sizeof(pipe_list_t));
-  if (global_pipes == NULL)
+  sync_slot_t *bigger = (sync_slot_t *)realloc(sync_slots, 2 * sync_capacity * sizeof(sync_slot_t));
+  if (bigger == NULL)
   {
-    TracePrintf(0, "Failed to allocate memory for global_pipes\n");
-    Halt();
+    return ERROR;
+  }
+  sync_slots = bigger;
+
+  for (int i = sync_capacity; i < 2 * sync_capacity; i++)
+  {
+    sync_slots[i].type = 0;
+    sync_slots[i].generation = 0;
+    sync_slots[i].object = NULL;
+    sync_slots[i].next_free = (i + 1 < 2 * sync_capacity) ? i + 1 : sync_free_head;
+    sync_slots[i].refs = 0;
+    sync_slots[i].last_user_pid = 0;
+  }
+  sync_free_head = sync_capacity;
+  sync_capacity *= 2;
+  return SUCCESS;
+}
+
+// Whether an ID still names the object in its slot
+static int IsLiveSyncId(int id)
+{
+  int slot = GET_SLOT(id);
+  return slot < sync_capacity && sync_slots[slot].type == GET_TYPE(id) &&
+         sync_slots[slot].generation == GET_GENERATION(id);
+}
+
+// Appends an ID to a process's references, first dropping IDs of objects reclaimed since
+static int AddSyncRef(pcb_t *pcb, int id)
+{
+  if (pcb->num_sync_refs == pcb->sync_refs_capacity)
+  {
+    int live = 0;
+    for (int i = 0; i < pcb->num_sync_refs; i++)
+    {
+      if (IsLiveSyncId(pcb->sync_refs[i]))
+      {
+        pcb->sync_refs[live++] = pcb->sync_refs[i];
+      }
+    }
+    pcb->num_sync_refs = live;
+  }
+
+  if (pcb->num_sync_refs == pcb->sync_refs_capacity)
+  {
+    int capacity = (pcb->sync_refs_capacity == 0) ? SYNC_INITIAL_REFS : 2 * pcb->sync_refs_capacity;
+    int *bigger = (int *)realloc(pcb->sync_refs, capacity * sizeof(int));
+    if (bigger == NULL)
+    {
+      return ERROR;
+    }
+    pcb->sync_refs = bigger;
+    pcb->sync_refs_capacity = capacity;
+  }
+
+  pcb->sync_refs[pcb->num_sync_refs++] = id;
+  return SUCCESS;
+}
+
+// Records that a process knows an object's ID, so the object outlives every other user
+static void ReferenceSyncSlot(pcb_t *pcb, int id)
+{
+  sync_slot_t *entry = &sync_slots[GET_SLOT(id)];
+  if (pcb == NULL || pcb == idle_pcb || entry->last_user_pid == pcb->pid)
+  {
+    return;
+  }
+
+  for (int i = 0; i < pcb->num_sync_refs; i++)
+  {
+    if (pcb->sync_refs[i] == id)
+    {
+      entry->last_user_pid = pcb->pid;
+      return;
+    }
+  }
+
+  // Without room to record it the count is never given back, so the object is simply never reclaimed
+  entry->refs++;
+  if (AddSyncRef(pcb, id) == SUCCESS)
+  {
+    entry->last_user_pid = pcb->pid;
+  }
+}
+
+// Places an object in a free slot and returns its ID, or ERROR if the table cannot grow
+static int AllocSyncSlot(int type, void *object)
+{
+  if (sync_free_head == -1 && GrowSyncSlots() == ERROR)
+  {
+    TracePrintf(0, "AllocSyncSlot: Sync object table is full\n");
+    return ERROR;
+  }
+
+  int slot = sync_free_head;
+  sync_free_head = sync_slots[slot].next_free;
+  sync_slots[slot].type = type;
+  sync_slots[slot].object = object;
+  sync_slots[slot].next_free = -1;
+  sync_slots[slot].refs = 0;
+  sync_slots[slot].last_user_pid = 0;
+
+  // The creator is the first process to reference the object
+  int id = MAKE_SYNC_ID(type, slot, sync_slots[slot].generation);
+  ReferenceSyncSlot(GetCurrentProcess(), id);
+  return id;
+}
+
+// Returns the object with this ID, or NULL if the type is wrong or the slot has been reused
+static void *LookupSyncSlot(int id, int type)
+{
+  int slot = GET_SLOT(id);
+  if (id <= 0 || GET_TYPE(id) != type || slot >= sync_capacity)
+  {
+    return NULL;
+  }
+  if (sync_slots[slot].type != type || sync_slots[slot].generation != GET_GENERATION(id))
+  {
+    return NULL;
+  }
+  return sync_slots[slot].object;
+}
+
+// Looks up an object named in a syscall; the calling process becomes one of its users.
+// Kernel-internal lookups (wake-ups, timeouts, kills, reclaims) go through Find* instead.
+static void *UseSyncSlot(int id, int type)
+{
+  void *object = LookupSyncSlot(id, type);
+  if (object != NULL)
+  {
+    ReferenceSyncSlot(GetCurrentProcess(), id);
+  }
+  return object;
+}
+
+// Returns a slot to the free list; the new generation invalidates outstanding IDs
+static void FreeSyncSlot(int id)
+{
+  int slot = GET_SLOT(id);
+  sync_slots[slot].type = 0;
+  sync_slots[slot].object = NULL;
+  sync_slots[slot].generation = (sync_slots[slot].generation + 1) & GENERATION_MASK;
+  sync_slots[slot].next_free = sync_free_head;
+  sync_free_head = slot;
+}
+
+// Links a lock into its new owner's held list
+static void AddHeldLock(pcb_t *pcb, lock_t *lock)
+{
+  lock->next_held = pcb->held_locks;
+  pcb->held_locks = lock;
+  lock->held_since = CurrentTick();
+
+  if (lock_profiling)
+  {
+    lock->profile.acquisitions++;
+    if (pcb->blocked_lock == lock)
+    {
+      int waited = lock->held_since - pcb->lock_wait_start;
+      lock->profile.wait_ticks += waited;
+      if (waited > lock->profile.max_wait_ticks)
+      {
+        lock->profile.max_wait_ticks = waited;
+      }
+    }
+  }
+}
+
+// Unlinks a lock from its owner's held list
+static void RemoveHeldLock(pcb_t *pcb, lock_t *lock)
+{
+  lock_t **link = &pcb->held_locks;
+  while (*link != NULL && *link != lock)
+  {
+    link = &(*link)->next_held;
+  }
+  if (*link != NULL)
+  {
+    *link = lock->next_held;
+  }
+  lock->next_held = NULL;
+
+  if (lock_profiling)
+  {
+    lock->profile.hold_ticks += CurrentTick() - lock->held_since;
+  }
+}
+
+// Recomputes a process's priority from its base and its lock waiters, returns 1 if it changed
+static int UpdateEffectivePriority(pcb_t *pcb)
+{
+  int priority = pcb->base_priority;
+  for (lock_t *lock = pcb->held_locks; lock != NULL; lock = lock->next_held)
+  {
+    for (pcb_t *waiter = lock->wait_queue->head; waiter != NULL; waiter = waiter->next)
+    {
+      if (waiter->priority < priority)
+      {
+        priority = waiter->priority;
+      }
+    }
+  }
+
+  if (priority == pcb->priority)
+  {
+    return 0;
+  }
+  TracePrintf(2, "UpdateEffectivePriority: pid %d priority %d -> %d\n", pcb->pid, pcb->priority, priority);
+  SetPriority(pcb, priority);
+  return 1;
+}
+
+// Passes a waiter's priority along the chain of lock owners, stopping where nothing changes
+static void PropagatePriority(pcb_t *owner)
+{
+  for (int depth = 0; owner != NULL && depth < PI_MAX_DEPTH; depth++)
+  {
+    if (!UpdateEffectivePriority(owner) || owner->blocked_lock == NULL)
+    {
+      return;
+    }
+    owner = owner->blocked_lock->owner;
+  }
+}
+
+// Queues a process on a held lock and lends its priority to the owner
+static void BlockOnLock(pcb_t *pcb, lock_t *lock)
+{
+  pcb_enqueue(lock->wait_queue, pcb);
+  pcb->blocked_lock = lock;
+  pcb->lock_wait_start = CurrentTick();
+
+  if (lock_profiling)
+  {
+    lock->profile.contended++;
+    if (lock->wait_queue->size > lock->profile.max_queue_depth)
+    {
+      lock->profile.max_queue_depth = lock->wait_queue->size;
+    }
+  }
+
+  PropagatePriority(lock->owner);
+}
+
+void SetBasePriority(pcb_t *pcb, int priority)
+{
+  pcb->base_priority = priority;
+  if (UpdateEffectivePriority(pcb) && pcb->blocked_lock != NULL)
+  {
+    PropagatePriority(pcb->blocked_lock->owner);
+  }
+}
+
+// Forgets the lock a process was queued on and withdraws the priority it lent the owner
+static void CancelLockWait(pcb_t *pcb)
+{
+  lock_t *lock = pcb->blocked_lock;
+  if (lock == NULL)
+  {
+    return;
+  }
+  pcb->blocked_lock = NULL;
+  PropagatePriority(lock->owner);
+}
+
+// Timer callback: pulls a process whose timed wait expired off the object's wait queue
+static void ExpireWait(pcb_t *pcb)
+{
+  // The wait may already have been satisfied by the time the timer fired
+  if (pcb->state != PCB_STATE_BLOCKED || pcb->queue == NULL)
+  {
+    return;
   }
-  global_pipes->head = NULL;
-  global_pipes->tail = NULL;
-  global_pipes->size = 0;
+
+  pcb_remove(pcb->queue, pcb);
+  CancelSyncWait(pcb);
+  pcb->wait_result = TIMEOUT;
+  MakeReady(pcb, SCHED_WOKEN);
+  TracePrintf(2, "ExpireWait: Wait of process %d timed out\n", pcb->pid);
+}
+
+void StartWaitTimeout(pcb_t *pcb, int ticks)
+{
+  pcb->wait_result = SUCCESS;
+  if (ticks > 0)
+  {
+    StartTimer(pcb, ticks, ExpireWait);
+  }
+}
+
+int EndWaitTimeout(pcb_t *pcb)
+{
+  CancelTimer(pcb);
+  return pcb->wait_result == TIMEOUT;
 }
 
 int LockInit(int *lock_idp)
@@ -51,6 +360,19 @@ int LockInit(int *lock_idp)
   {
     return ERROR;
   }
+  pcb_t *creator = GetCurrentProcess();
+  if (IsOverLimit(creator, LIMIT_SYNC_OBJECTS, creator->num_sync_objects))
+  {
+    TracePrintf(0, "LockInit: Process %d reached its synchronization object limit\n", creator->pid);
+    return ERROR;
+  }
+
+  // Split a merged page now, so a failure has nothing to undo
+  if (PrepareUserWrite(lock_idp, sizeof(int)) == ERROR)
+  {
+    return ERROR;
+  }
+
   lock_t *lock = malloc(sizeof(lock_t));
   if (lock == NULL)
   {
@@ -58,23 +380,20 @@ int LockInit(int *lock_idp)
   }
   lock->is_locked = 0;
   lock->owner = NULL;
+  lock->next_held = NULL;
+  lock->held_since = 0;
+  memset(&lock->profile, 0, sizeof(lock_profile_t));
   lock->wait_queue = pcb_queue_create();
-  lock->id = LOCK_ID_FLAG | next_sync_id++;
-  lock->next = NULL;
-  lock->prev = NULL;
-
-  if (global_locks->head == NULL)
-  {
-    global_locks->head = lock;
-    global_locks->tail = lock;
-  }
-  else
+  lock->id = AllocSyncSlot(LOCK_ID_FLAG, lock);
+  if (lock->id == ERROR)
   {
-    global_locks->tail->next = lock;
-    lock->prev = global_locks->tail;
-    global_locks->tail = lock;
+    free(lock->wait_queue);
+    free(lock);
+    return ERROR;
   }
-  global_locks->size++;
+  lock->creator_pid = creator->pid;
+  creator->num_sync_objects++;
+  lock->profile.id = lock->id;
   *lock_idp = lock->id;
 
   TracePrintf(0, "Lock initialized with id %d\n", lock->id);
@@ -83,12 +402,17 @@ int LockInit(int *lock_idp)
 
 int Acquire(int lock_id)
 {
-  if (lock_id <= 0)
+  return AcquireTimed(lock_id, 0);
+}
+
+int AcquireTimed(int lock_id, int ticks)
+{
+  if (lock_id <= 0 || ticks < 0)
   {
     return ERROR;
   }
 
-  lock_t *current = FindLock(lock_id);
+  lock_t *current = (lock_t *)UseSyncSlot(lock_id, LOCK_ID_FLAG);
 
   if (current == NULL)
   {
@@ -98,11 +422,11 @@ int Acquire(int lock_id)
   pcb_t *pcb = GetCurrentProcess();
   if (current->is_locked)
   {
-    pcb_enqueue(current->wait_queue, pcb);
+    BlockOnLock(pcb, current);
     pcb->state = PCB_STATE_BLOCKED;
-    pcb_enqueue(blocked_processes, pcb);
+    StartWaitTimeout(pcb, ticks);
 
-    pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+    pcb_t *next = PickNextProcess();
 
     int rc = KernelContextSwitch(KCSwitch, pcb, next);
     if (rc == -1)
@@ -111,12 +435,19 @@ int Acquire(int lock_id)
       Halt();
     }
 
+    if (EndWaitTimeout(pcb))
+    {
+      TracePrintf(0, "Process %d timed out waiting for lock %d\n", pcb->pid, lock_id);
+      return TIMEOUT;
+    }
+
     TracePrintf(0, "Lock acquired by process %d after waiting\n", pcb->pid);
     return SUCCESS;
   }
 
   current->is_locked = 1;
   current->owner = pcb;
+  AddHeldLock(pcb, current);
   TracePrintf(0, "Lock acquired by process %d\n", pcb->pid);
   return SUCCESS;
 }
@@ -135,7 +466,7 @@ int Release(int lock_id)
     return ERROR;
   }
 
-  lock_t *current = FindLock(lock_id);
+  lock_t *current = (lock_t *)UseSyncSlot(lock_id, LOCK_ID_FLAG);
 
   if (current == NULL)
   {
@@ -149,154 +480,875 @@ int Release(int lock_id)
     return ERROR;
   }
 
-  current->is_locked = 0;
-  current->owner = NULL;
+  HandOffLock(current);
 
-  if (current->wait_queue->head != NULL)
+  TracePrintf(0, "Lock released by process %d\n", pcb->pid);
+
+  // The new owner, if any, can run right away in handoff mode
+  DirectedYield(current->owner);
+  return SUCCESS;
+}
+
+void HandOffLock(lock_t *lock)
+{
+  pcb_t *previous = lock->owner;
+  lock->is_locked = 0;
+  lock->owner = NULL;
+  RemoveHeldLock(previous, lock);
+
+  if (lock->wait_queue->head != NULL)
   {
-    pcb_t *next = pcb_dequeue(current->wait_queue);
+    pcb_t *next = pcb_dequeue(lock->wait_queue);
+    lock->is_locked = 1;
+    lock->owner = next;
+    AddHeldLock(next, lock);
+    next->blocked_lock = NULL;
+
+    // The new owner inherits from the waiters still queued behind it
+    UpdateEffectivePriority(next);
     next->state = PCB_STATE_READY;
-    pcb_remove(blocked_processes, next);
-    pcb_enqueue(ready_processes, next);
+    MakeReady(next, SCHED_WOKEN);
+    TracePrintf(0, "Lock %d transferred from process %d to process %d\n", lock->id, previous->pid, next->pid);
+  }
+  else
+  {
+    TracePrintf(0, "Lock %d released by process %d with no waiters\n", lock->id, previous->pid);
+  }
+
+  // Drop whatever the previous owner inherited through this lock
+  UpdateEffectivePriority(previous);
+}
+
+void ReleaseLocksHeldBy(pcb_t *pcb)
+{
+  while (pcb->held_locks != NULL)
+  {
+    HandOffLock(pcb->held_locks);
+  }
+}
+
+void CancelPipeWrite(pcb_t *pcb)
+{
+  write_request_t *request = pcb->write_request;
+  if (request == NULL)
+  {
+    return;
+  }
+
+  write_queue_t *queue = request->queue;
+  if (request->prev == NULL)
+  {
+    queue->head = request->next;
+  }
+  else
+  {
+    request->prev->next = request->next;
+  }
+
+  if (request->next == NULL)
+  {
+    queue->tail = request->prev;
+  }
+  else
+  {
+    request->next->prev = request->prev;
+  }
+  queue->size--;
+
+  free(request->buffer);
+  free(request);
+  pcb->write_request = NULL;
+}
+
+int CvarInit(int *cvar_idp)
+{
+  if (cvar_idp == NULL)
+  {
+    TracePrintf(0, "cvar_idp is NULL\n");
+    return ERROR;
+  }
+  pcb_t *creator = GetCurrentProcess();
+  if (IsOverLimit(creator, LIMIT_SYNC_OBJECTS, creator->num_sync_objects))
+  {
+    TracePrintf(0, "CvarInit: Process %d reached its synchronization object limit\n", creator->pid);
+    return ERROR;
+  }
+
+  if (PrepareUserWrite(cvar_idp, sizeof(int)) == ERROR)
+  {
+    return ERROR;
+  }
+
+  cond_t *condvar = malloc(sizeof(cond_t));
+  if (condvar == NULL)
+  {
+    TracePrintf(0, "Failed to allocate memory for condvar\n");
+    return ERROR;
+  }
+  condvar->wait_queue = pcb_queue_create();
+  condvar->id = AllocSyncSlot(CONDVAR_ID_FLAG, condvar);
+  if (condvar->id == ERROR)
+  {
+    free(condvar->wait_queue);
+    free(condvar);
+    return ERROR;
+  }
+  condvar->creator_pid = creator->pid;
+  creator->num_sync_objects++;
+  *cvar_idp = condvar->id;
+
+  TracePrintf(0, "Condition variable initialized with id %d\n", condvar->id);
+  return SUCCESS;
+}
+
+int CvarWait(int cvar_id, int lock_id)
+{
+  return CvarWaitTimed(cvar_id, lock_id, 0);
+}
+
+int CvarWaitTimed(int cvar_id, int lock_id, int ticks)
+{
+  if (cvar_id <= 0 || lock_id <= 0 || ticks < 0)
+  {
+    return ERROR;
+  }
 
-    current->is_locked = 1;
-    current->owner = next;
-    TracePrintf(0, "Lock %d transferred from process %d to process %d\n", lock_id, pcb->pid, next->pid);
+  pcb_t *pcb = GetCurrentProcess();
+  cond_t *condvar = (cond_t *)UseSyncSlot(cvar_id, CONDVAR_ID_FLAG);
+  lock_t *held = (lock_t *)UseSyncSlot(lock_id, LOCK_ID_FLAG);
+  if (condvar == NULL || held == NULL || held->owner != pcb)
+  {
+    return ERROR;
+  }
+
+  // Queue on the condition variable before the lock goes, so a signal sent by
+  // the next owner cannot slip in between; the signaler can then also move us
+  // straight onto the lock's queue instead of waking us just to block again
+  pcb->cvar_lock_id = lock_id;
+  pcb_enqueue(condvar->wait_queue, pcb);
+  pcb->state = PCB_STATE_BLOCKED;
+
+  // Release without Release's directed yield: we are switching away anyway
+  HandOffLock(held);
+  StartWaitTimeout(pcb, ticks);
+
+  pcb_t *next = PickNextProcess();
+
+  int rc = KernelContextSwitch(KCSwitch, pcb, next);
+  if (rc == -1)
+  {
+    TracePrintf(0, "KernelContextSwitch failed when waiting for condition variable\n");
+    Halt();
+  }
+  int timed_out = EndWaitTimeout(pcb);
+  pcb->cvar_lock_id = 0;
+
+  // A morphed waiter already owns the lock when it wakes; a timed-out one must still take it back
+  lock_t *lock = FindLock(lock_id);
+  if (lock == NULL || lock->owner != pcb)
+  {
+    int rc = Acquire(lock_id);
+    if (rc != SUCCESS)
+    {
+      TracePrintf(0, "Process %d could not reacquire lock %d after waiting on condition variable %d\n",
+                  pcb->pid, lock_id, cvar_id);
+      return rc;
+    }
+  }
+
+  if (timed_out)
+  {
+    TracePrintf(0, "Process %d timed out waiting on condition variable %d\n", pcb->pid, cvar_id);
+    return TIMEOUT;
+  }
+
+  TracePrintf(0, "Process %d waiting on condition variable %d has been resumed\n", pcb->pid, cvar_id);
+  return SUCCESS;
+}
+
+// Moves a signalled waiter onto its lock: it only becomes ready if it can take the lock now
+static int WakeCvarWaiter(pcb_t *waiter)
+{
+  lock_t *lock = FindLock(waiter->cvar_lock_id);
+  waiter->cvar_lock_id = 0;
+
+  // The signal is consumed; a timeout firing while it queues for the lock would lose it
+  CancelTimer(waiter);
+
+  if (lock != NULL && lock->is_locked)
+  {
+    BlockOnLock(waiter, lock);
+    TracePrintf(2, "Process %d moved to the wait queue of lock %d\n", waiter->pid, lock->id);
+    return 0;
+  }
+
+  if (lock != NULL)
+  {
+    lock->is_locked = 1;
+    lock->owner = waiter;
+    AddHeldLock(waiter, lock);
+  }
+  waiter->state = PCB_STATE_READY;
+  MakeReady(waiter, SCHED_WOKEN);
+  return 1;
+}
+
+int CvarSignal(int cvar_id)
+{
+  if (cvar_id <= 0)
+  {
+    return ERROR;
+  }
+
+  cond_t *condvar = (cond_t *)UseSyncSlot(cvar_id, CONDVAR_ID_FLAG);
+
+  if (condvar == NULL)
+  {
+    return ERROR;
+  }
+
+  pcb_t *next = NULL;
+  if (condvar->wait_queue->head != NULL)
+  {
+    next = pcb_dequeue(condvar->wait_queue);
+    TracePrintf(0, "Process %d has been resumed from condition variable %d\n", next->pid, cvar_id);
+
+    // Only hand off the CPU if the waiter got the lock and can actually run
+    if (!WakeCvarWaiter(next))
+    {
+      next = NULL;
+    }
+  }
+  else
+  {
+    TracePrintf(0, "Condition variable %d has no waiters\n", cvar_id);
+  }
+
+  TracePrintf(0, "Condition variable %d signaled\n", cvar_id);
+  DirectedYield(next);
+  return SUCCESS;
+}
+
+int CvarBroadcast(int cvar_id)
+{
+  if (cvar_id <= 0)
+  {
+    return ERROR;
+  }
+
+  cond_t *condvar = (cond_t *)UseSyncSlot(cvar_id, CONDVAR_ID_FLAG);
+  if (condvar == NULL)
+  {
+    return ERROR;
+  }
+  while (condvar->wait_queue->head != NULL)
+  {
+    pcb_t *pcb = pcb_dequeue(condvar->wait_queue);
+    WakeCvarWaiter(pcb);
+    TracePrintf(0, "Process %d has been resumed from condition variable %d\n", pcb->pid, cvar_id);
+  }
+  TracePrintf(0, "Condition variable %d broadcasted\n", cvar_id);
+  return SUCCESS;
+}
+
+int RWLockInit(int *rwlock_idp)
+{
+  if (rwlock_idp == NULL)
+  {
+    return ERROR;
+  }
+  pcb_t *creator = GetCurrentProcess();
+  if (IsOverLimit(creator, LIMIT_SYNC_OBJECTS, creator->num_sync_objects))
+  {
+    TracePrintf(0, "RWLockInit: Process %d reached its synchronization object limit\n", creator->pid);
+    return ERROR;
+  }
+
+  if (PrepareUserWrite(rwlock_idp, sizeof(int)) == ERROR)
+  {
+    return ERROR;
+  }
+
+  rwlock_t *rwlock = malloc(sizeof(rwlock_t));
+  if (rwlock == NULL)
+  {
+    return ERROR;
+  }
+  rwlock->writer = NULL;
+  rwlock->readers = NULL;
+  rwlock->num_readers = 0;
+  rwlock->readers_capacity = 0;
+  rwlock->read_queue = pcb_queue_create();
+  rwlock->write_queue = pcb_queue_create();
+  if (rwlock->read_queue == NULL || rwlock->write_queue == NULL)
+  {
+    free(rwlock->read_queue);
+    free(rwlock->write_queue);
+    free(rwlock);
+    return ERROR;
+  }
+
+  rwlock->id = AllocSyncSlot(RWLOCK_ID_FLAG, rwlock);
+  if (rwlock->id == ERROR)
+  {
+    free(rwlock->read_queue);
+    free(rwlock->write_queue);
+    free(rwlock);
+    return ERROR;
+  }
+  rwlock->creator_pid = creator->pid;
+  creator->num_sync_objects++;
+  *rwlock_idp = rwlock->id;
+
+  TracePrintf(0, "Reader-writer lock initialized with id %d\n", rwlock->id);
+  return SUCCESS;
+}
+
+// Records a process as a reader, growing the reader array if needed
+static int AddReader(rwlock_t *rwlock, pcb_t *pcb)
+{
+  if (rwlock->num_readers == rwlock->readers_capacity)
+  {
+    int capacity = (rwlock->readers_capacity == 0) ? 4 : 2 * rwlock->readers_capacity;
+    pcb_t **bigger = (pcb_t **)realloc(rwlock->readers, capacity * sizeof(pcb_t *));
+    if (bigger == NULL)
+    {
+      return ERROR;
+    }
+    rwlock->readers = bigger;
+    rwlock->readers_capacity = capacity;
+  }
+  rwlock->readers[rwlock->num_readers++] = pcb;
+  pcb->rw_holds++;
+  return SUCCESS;
+}
+
+// Removes a process from the readers, returns ERROR if it was not reading
+static int RemoveReader(rwlock_t *rwlock, pcb_t *pcb)
+{
+  for (int i = 0; i < rwlock->num_readers; i++)
+  {
+    if (rwlock->readers[i] == pcb)
+    {
+      rwlock->readers[i] = rwlock->readers[--rwlock->num_readers];
+      pcb->rw_holds--;
+      return SUCCESS;
+    }
+  }
+  return ERROR;
+}
+
+// Hands a free or read-held lock to its waiters: after a writer, the whole reader batch goes first
+static void DispatchRWLock(rwlock_t *rwlock, int readers_first)
+{
+  if (rwlock->writer != NULL)
+  {
+    return;
+  }
+
+  if (readers_first || pcb_queue_is_empty(rwlock->write_queue))
+  {
+    while (!pcb_queue_is_empty(rwlock->read_queue))
+    {
+      pcb_t *reader = pcb_dequeue(rwlock->read_queue);
+      reader->blocked_sync_id = 0;
+      if (AddReader(rwlock, reader) == ERROR)
+      {
+        // Out of memory: the reader retries the whole acquire
+        reader->wait_result = ERROR;
+      }
+      MakeReady(reader, SCHED_WOKEN);
+    }
+  }
+
+  if (rwlock->num_readers == 0 && !pcb_queue_is_empty(rwlock->write_queue))
+  {
+    rwlock->writer = pcb_dequeue(rwlock->write_queue);
+    rwlock->writer->blocked_sync_id = 0;
+    rwlock->writer->rw_holds++;
+    MakeReady(rwlock->writer, SCHED_WOKEN);
+  }
+}
+
+int AcquireRead(int rwlock_id)
+{
+  rwlock_t *rwlock = (rwlock_t *)UseSyncSlot(rwlock_id, RWLOCK_ID_FLAG);
+  if (rwlock == NULL)
+  {
+    return ERROR;
+  }
+
+  pcb_t *pcb = GetCurrentProcess();
+  if (rwlock->writer == NULL && pcb_queue_is_empty(rwlock->write_queue))
+  {
+    return AddReader(rwlock, pcb);
+  }
+
+  // A writer holds or is waiting for the lock: join the next reader batch
+  pcb->wait_result = SUCCESS;
+  pcb->blocked_sync_id = rwlock_id;
+  pcb_enqueue(rwlock->read_queue, pcb);
+  pcb->state = PCB_STATE_BLOCKED;
+
+  pcb_t *next = PickNextProcess();
+  int rc = KernelContextSwitch(KCSwitch, pcb, next);
+  if (rc == -1)
+  {
+    TracePrintf(0, "AcquireRead: KernelContextSwitch failed\n");
+    Halt();
+  }
+
+  return pcb->wait_result;
+}
+
+int AcquireWrite(int rwlock_id)
+{
+  rwlock_t *rwlock = (rwlock_t *)UseSyncSlot(rwlock_id, RWLOCK_ID_FLAG);
+  if (rwlock == NULL)
+  {
+    return ERROR;
+  }
+
+  pcb_t *pcb = GetCurrentProcess();
+  if (rwlock->writer == NULL && rwlock->num_readers == 0)
+  {
+    rwlock->writer = pcb;
+    pcb->rw_holds++;
+    return SUCCESS;
+  }
+
+  pcb->blocked_sync_id = rwlock_id;
+  pcb_enqueue(rwlock->write_queue, pcb);
+  pcb->state = PCB_STATE_BLOCKED;
+
+  pcb_t *next = PickNextProcess();
+  int rc = KernelContextSwitch(KCSwitch, pcb, next);
+  if (rc == -1)
+  {
+    TracePrintf(0, "AcquireWrite: KernelContextSwitch failed\n");
+    Halt();
+  }
+
+  // DispatchRWLock made us the writer before waking us
+  return SUCCESS;
+}
+
+int ReleaseRW(int rwlock_id)
+{
+  rwlock_t *rwlock = (rwlock_t *)UseSyncSlot(rwlock_id, RWLOCK_ID_FLAG);
+  if (rwlock == NULL)
+  {
+    return ERROR;
+  }
+
+  pcb_t *pcb = GetCurrentProcess();
+  if (rwlock->writer == pcb)
+  {
+    rwlock->writer = NULL;
+    pcb->rw_holds--;
+    DispatchRWLock(rwlock, 1);
+    return SUCCESS;
+  }
+
+  if (RemoveReader(rwlock, pcb) == ERROR)
+  {
+    TracePrintf(0, "ReleaseRW: Process %d does not hold lock %d\n", pcb->pid, rwlock_id);
+    return ERROR;
+  }
+  DispatchRWLock(rwlock, 0);
+  return SUCCESS;
+}
+
+int SysSemInit(int *sem_idp, int count)
+{
+  if (sem_idp == NULL || count < 0)
+  {
+    return ERROR;
+  }
+  pcb_t *creator = GetCurrentProcess();
+  if (IsOverLimit(creator, LIMIT_SYNC_OBJECTS, creator->num_sync_objects))
+  {
+    TracePrintf(0, "SysSemInit: Process %d reached its synchronization object limit\n", creator->pid);
+    return ERROR;
+  }
+
+  if (PrepareUserWrite(sem_idp, sizeof(int)) == ERROR)
+  {
+    return ERROR;
+  }
+
+  semaphore_t *sem = malloc(sizeof(semaphore_t));
+  if (sem == NULL)
+  {
+    return ERROR;
+  }
+  sem->count = count;
+  sem->wait_queue = pcb_queue_create();
+  if (sem->wait_queue == NULL)
+  {
+    free(sem);
+    return ERROR;
+  }
+
+  sem->id = AllocSyncSlot(SEM_ID_FLAG, sem);
+  if (sem->id == ERROR)
+  {
+    free(sem->wait_queue);
+    free(sem);
+    return ERROR;
+  }
+  sem->creator_pid = creator->pid;
+  creator->num_sync_objects++;
+  *sem_idp = sem->id;
+
+  TracePrintf(0, "Semaphore initialized with id %d and count %d\n", sem->id, count);
+  return SUCCESS;
+}
+
+int SysSemDown(int sem_id)
+{
+  semaphore_t *sem = (semaphore_t *)UseSyncSlot(sem_id, SEM_ID_FLAG);
+  if (sem == NULL)
+  {
+    return ERROR;
+  }
+
+  if (sem->count > 0)
+  {
+    sem->count--;
+    return SUCCESS;
+  }
+
+  pcb_t *pcb = GetCurrentProcess();
+  pcb_enqueue(sem->wait_queue, pcb);
+  pcb->state = PCB_STATE_BLOCKED;
+
+  pcb_t *next = PickNextProcess();
+  int rc = KernelContextSwitch(KCSwitch, pcb, next);
+  if (rc == -1)
+  {
+    TracePrintf(0, "SysSemDown: KernelContextSwitch failed\n");
+    Halt();
+  }
+
+  // SysSemUp handed us a unit directly
+  return SUCCESS;
+}
+
+int SysSemUp(int sem_id, int count)
+{
+  semaphore_t *sem = (semaphore_t *)UseSyncSlot(sem_id, SEM_ID_FLAG);
+  if (sem == NULL || count <= 0)
+  {
+    return ERROR;
   }
-  else
+
+  // Units go to waiters first; only the remainder is banked
+  pcb_t *first = NULL;
+  while (count > 0 && !pcb_queue_is_empty(sem->wait_queue))
   {
-    TracePrintf(0, "Lock %d released by process %d with no waiters\n", lock_id, pcb->pid);
+    pcb_t *waiter = pcb_dequeue(sem->wait_queue);
+    MakeReady(waiter, SCHED_WOKEN);
+    if (first == NULL)
+    {
+      first = waiter;
+    }
+    count--;
   }
+  sem->count += count;
 
-  TracePrintf(0, "Lock released by process %d\n", pcb->pid);
+  TracePrintf(2, "SysSemUp: Semaphore %d count now %d\n", sem_id, sem->count);
+  DirectedYield(first);
   return SUCCESS;
 }
 
-int CvarInit(int *cvar_idp)
+int BarrierInit(int *barrier_idp, int parties)
 {
-  if (cvar_idp == NULL)
+  if (barrier_idp == NULL || parties < 1)
   {
-    TracePrintf(0, "cvar_idp is NULL\n");
+    return ERROR;
+  }
+  pcb_t *creator = GetCurrentProcess();
+  if (IsOverLimit(creator, LIMIT_SYNC_OBJECTS, creator->num_sync_objects))
+  {
+    TracePrintf(0, "BarrierInit: Process %d reached its synchronization object limit\n", creator->pid);
     return ERROR;
   }
 
-  cond_t *condvar = malloc(sizeof(cond_t));
-  if (condvar == NULL)
+  if (PrepareUserWrite(barrier_idp, sizeof(int)) == ERROR)
   {
-    TracePrintf(0, "Failed to allocate memory for condvar\n");
     return ERROR;
   }
-  condvar->id = CONDVAR_ID_FLAG | next_sync_id++;
-  condvar->wait_queue = pcb_queue_create();
-  condvar->next = NULL;
-  condvar->prev = NULL;
 
-  if (global_condvars->head == NULL)
+  barrier_t *barrier = malloc(sizeof(barrier_t));
+  if (barrier == NULL)
   {
-    global_condvars->head = condvar;
-    global_condvars->tail = condvar;
+    return ERROR;
   }
-  else
+  barrier->parties = parties;
+  barrier->arrived = 0;
+  barrier->wait_queue = pcb_queue_create();
+  if (barrier->wait_queue == NULL)
   {
-    global_condvars->tail->next = condvar;
-    condvar->prev = global_condvars->tail;
-    global_condvars->tail = condvar;
+    free(barrier);
+    return ERROR;
   }
-  global_condvars->size++;
-  *cvar_idp = condvar->id;
 
-  TracePrintf(0, "Condition variable initialized with id %d\n", condvar->id);
+  barrier->id = AllocSyncSlot(BARRIER_ID_FLAG, barrier);
+  if (barrier->id == ERROR)
+  {
+    free(barrier->wait_queue);
+    free(barrier);
+    return ERROR;
+  }
+  barrier->creator_pid = creator->pid;
+  creator->num_sync_objects++;
+  *barrier_idp = barrier->id;
+
+  TracePrintf(0, "Barrier initialized with id %d for %d processes\n", barrier->id, parties);
   return SUCCESS;
 }
 
-int CvarWait(int cvar_id, int lock_id)
+int BarrierWait(int barrier_id)
 {
-  if (cvar_id <= 0 || lock_id <= 0)
+  barrier_t *barrier = (barrier_t *)UseSyncSlot(barrier_id, BARRIER_ID_FLAG);
+  if (barrier == NULL)
   {
     return ERROR;
   }
 
-  Release(lock_id);
   pcb_t *pcb = GetCurrentProcess();
-  pcb->state = PCB_STATE_BLOCKED;
-
-  cond_t *condvar = FindCondvar(cvar_id);
-  if (condvar == NULL)
+  if (++barrier->arrived == barrier->parties)
   {
-    return ERROR;
+    // Last arriver: release the whole phase and keep running as its serial process.
+    // The queue cannot be spliced onto a ready queue in one step: each waiter may
+    // belong to a different place (MLFQ level, priority bucket, CFS heap, group,
+    // real-time queue), so every one goes through MakeReady.
+    while (!pcb_queue_is_empty(barrier->wait_queue))
+    {
+      pcb_t *waiter = pcb_dequeue(barrier->wait_queue);
+      waiter->blocked_sync_id = 0;
+      MakeReady(waiter, SCHED_WOKEN);
+    }
+    barrier->arrived = 0;
+    TracePrintf(2, "BarrierWait: Barrier %d opened by process %d\n", barrier_id, pcb->pid);
+    return BARRIER_SERIAL;
   }
 
-  pcb_enqueue(condvar->wait_queue, pcb);
-  pcb_enqueue(blocked_processes, pcb);
-
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+  pcb->blocked_sync_id = barrier_id;
+  pcb_enqueue(barrier->wait_queue, pcb);
+  pcb->state = PCB_STATE_BLOCKED;
 
+  pcb_t *next = PickNextProcess();
   int rc = KernelContextSwitch(KCSwitch, pcb, next);
   if (rc == -1)
   {
-    TracePrintf(0, "KernelContextSwitch failed when waiting for condition variable\n");
+    TracePrintf(0, "BarrierWait: KernelContextSwitch failed\n");
     Halt();
   }
 
-  Acquire(lock_id);
+  return 0;
+}
 
-  TracePrintf(0, "Process %d waiting on condition variable %d has been resumed\n", pcb->pid, cvar_id);
-  return SUCCESS;
+void CancelSyncWait(pcb_t *pcb)
+{
+  CancelLockWait(pcb);
+
+  int id = pcb->blocked_sync_id;
+  pcb->blocked_sync_id = 0;
+  if (IS_BARRIER(id))
+  {
+    barrier_t *barrier = FindBarrier(id);
+    if (barrier != NULL)
+    {
+      barrier->arrived--;
+    }
+  }
+  else if (IS_RWLOCK(id))
+  {
+    // A departed writer may have been all that held back the queued readers
+    rwlock_t *rwlock = FindRWLock(id);
+    if (rwlock != NULL)
+    {
+      DispatchRWLock(rwlock, 0);
+    }
+  }
 }
 
-int CvarSignal(int cvar_id)
+// Drops every read or write hold a process has on reader-writer locks
+static void ReleaseRWHoldsOf(pcb_t *pcb)
 {
-  if (cvar_id <= 0)
+  for (int slot = 0; slot < sync_capacity && pcb->rw_holds > 0; slot++)
   {
-    return ERROR;
+    if (sync_slots[slot].type != RWLOCK_ID_FLAG)
+    {
+      continue;
+    }
+
+    rwlock_t *rwlock = sync_slots[slot].object;
+    if (rwlock->writer == pcb)
+    {
+      rwlock->writer = NULL;
+      pcb->rw_holds--;
+      DispatchRWLock(rwlock, 1);
+    }
+    while (RemoveReader(rwlock, pcb) == SUCCESS)
+    {
+      DispatchRWLock(rwlock, 0);
+    }
   }
+}
 
-  cond_t *condvar = FindCondvar(cvar_id);
+// Whether any process is queued on, or holds, the object in a slot
+static int IsSyncObjectBusy(int slot)
+{
+  void *object = sync_slots[slot].object;
+  switch (sync_slots[slot].type)
+  {
+  case LOCK_ID_FLAG:
+    return ((lock_t *)object)->is_locked;
+  case CONDVAR_ID_FLAG:
+    return !pcb_queue_is_empty(((cond_t *)object)->wait_queue);
+  case PIPE_ID_FLAG:
+    return !pcb_queue_is_empty(((pipe_t *)object)->read_queue) ||
+           ((pipe_t *)object)->write_queue->head != NULL;
+  case RWLOCK_ID_FLAG:
+    return ((rwlock_t *)object)->writer != NULL || ((rwlock_t *)object)->num_readers > 0;
+  case SEM_ID_FLAG:
+    return !pcb_queue_is_empty(((semaphore_t *)object)->wait_queue);
+  case BARRIER_ID_FLAG:
+    return !pcb_queue_is_empty(((barrier_t *)object)->wait_queue);
+  }
+  return 0;
+}
 
-  if (condvar == NULL)
+void ReleaseSyncObjects(pcb_t *pcb)
+{
+  ReleaseLocksHeldBy(pcb);
+  ReleaseRWHoldsOf(pcb);
+
+  // Objects no surviving process has created, used or inherited are freed
+  for (int i = 0; i < pcb->num_sync_refs; i++)
   {
-    return ERROR;
+    int id = pcb->sync_refs[i];
+    if (!IsLiveSyncId(id))
+    {
+      continue;
+    }
+
+    sync_slot_t *entry = &sync_slots[GET_SLOT(id)];
+    if (entry->last_user_pid == pcb->pid)
+    {
+      entry->last_user_pid = 0;
+    }
+    if (--entry->refs == 0 && !IsSyncObjectBusy(GET_SLOT(id)))
+    {
+      TracePrintf(2, "ReleaseSyncObjects: Reclaiming object %d after its last user %d exited\n", id, pcb->pid);
+      Reclaim(id);
+    }
   }
 
-  if (condvar->wait_queue->head != NULL)
-  {
-    pcb_t *next = pcb_dequeue(condvar->wait_queue);
-    next->state = PCB_STATE_READY;
-    pcb_remove(blocked_processes, next);
-    pcb_enqueue(ready_processes, next);
+  free(pcb->sync_refs);
+  pcb->sync_refs = NULL;
+  pcb->num_sync_refs = 0;
+  pcb->sync_refs_capacity = 0;
+}
 
-    TracePrintf(0, "Process %d has been resumed from condition variable %d\n", next->pid, cvar_id);
+int InheritSyncRefs(pcb_t *child, pcb_t *parent)
+{
+  if (parent->num_sync_refs == 0)
+  {
+    return SUCCESS;
   }
-  else
+
+  child->sync_refs = (int *)malloc(parent->num_sync_refs * sizeof(int));
+  if (child->sync_refs == NULL)
   {
-    TracePrintf(0, "Condition variable %d has no waiters\n", cvar_id);
+    return ERROR;
   }
+  child->sync_refs_capacity = parent->num_sync_refs;
 
-  TracePrintf(0, "Condition variable %d signaled\n", cvar_id);
+  for (int i = 0; i < parent->num_sync_refs; i++)
+  {
+    int id = parent->sync_refs[i];
+    if (IsLiveSyncId(id))
+    {
+      sync_slots[GET_SLOT(id)].refs++;
+      child->sync_refs[child->num_sync_refs++] = id;
+    }
+  }
   return SUCCESS;
 }
 
-int CvarBroadcast(int cvar_id)
+void SetLockProfiling(int enabled)
 {
-  if (cvar_id <= 0)
+  lock_profiling = enabled;
+  TracePrintf(0, "SetLockProfiling: Lock profiling %s\n", enabled ? "on" : "off");
+}
+
+// Whether lock a is more contended than lock b
+static int MoreContended(lock_t *a, lock_t *b)
+{
+  if (a->profile.contended != b->profile.contended)
+  {
+    return a->profile.contended > b->profile.contended;
+  }
+  return a->profile.wait_ticks > b->profile.wait_ticks;
+}
+
+int SysLockProfile(int enable, lock_profile_t *stats, int count)
+{
+  if (count < 0)
   {
     return ERROR;
   }
+  if (enable >= 0)
+  {
+    SetLockProfiling(enable);
+  }
+  if (stats == NULL || count == 0)
+  {
+    return 0;
+  }
+  if (count > LOCK_PROFILE_MAX)
+  {
+    count = LOCK_PROFILE_MAX;
+  }
 
-  cond_t *condvar = FindCondvar(cvar_id);
-  if (condvar == NULL)
+  // Keep the top locks in a small array sorted by insertion
+  lock_t *top[LOCK_PROFILE_MAX];
+  int found = 0;
+  for (int slot = 0; slot < sync_capacity; slot++)
+  {
+    if (sync_slots[slot].type != LOCK_ID_FLAG)
+    {
+      continue;
+    }
+
+    lock_t *lock = sync_slots[slot].object;
+    if (found == count && !MoreContended(lock, top[found - 1]))
+    {
+      continue;
+    }
+
+    int i = (found < count) ? found++ : found - 1;
+    while (i > 0 && MoreContended(lock, top[i - 1]))
+    {
+      top[i] = top[i - 1];
+      i--;
+    }
+    top[i] = lock;
+  }
+
+  if (PrepareUserWrite(stats, found * sizeof(lock_profile_t)) == ERROR)
   {
     return ERROR;
   }
-  for (pcb_t *pcb = condvar->wait_queue->head; pcb != NULL; pcb = pcb->next)
+  for (int i = 0; i < found; i++)
   {
-    pcb->state = PCB_STATE_READY;
-    pcb_remove(blocked_processes, pcb);
-    pcb_enqueue(ready_processes, pcb);
-    TracePrintf(0, "Process %d has been resumed from condition variable %d\n", pcb->pid, cvar_id);
+    memcpy(&stats[i], &top[i]->profile, sizeof(lock_profile_t));
   }
-  TracePrintf(0, "Condition variable %d broadcasted\n", cvar_id);
-  return SUCCESS;
+  return found;
 }
 
 int Reclaim(int id)
@@ -307,15 +1359,27 @@ int Reclaim(int id)
   }
   if (IS_LOCK(id))
   {
-    return ReclaimLockHelper(global_locks->head, id);
+    return ReclaimLockHelper(id);
   }
   else if (IS_CONDVAR(id))
   {
-    return ReclaimCondvarHelper(global_condvars->head, id);
+    return ReclaimCondvarHelper(id);
   }
   else if (IS_PIPE(id))
   {
-    return ReclaimPipeHelper(global_pipes->head, id);
+    return ReclaimPipeHelper(id);
+  }
+  else if (IS_RWLOCK(id))
+  {
+    return ReclaimRWLockHelper(id);
+  }
+  else if (IS_SEM(id))
+  {
+    return ReclaimSemHelper(id);
+  }
+  else if (IS_BARRIER(id))
+  {
+    return ReclaimBarrierHelper(id);
   }
 
   TracePrintf(0, "Invalid ID %d, cannot reclaim\n", id);
@@ -329,6 +1393,17 @@ int PipeInit(int *pipe_idp)
     TracePrintf(0, "PipeInit: pipe_idp is NULL\n");
     return ERROR;
   }
+  pcb_t *creator = GetCurrentProcess();
+  if (IsOverLimit(creator, LIMIT_SYNC_OBJECTS, creator->num_sync_objects))
+  {
+    TracePrintf(0, "PipeInit: Process %d reached its synchronization object limit\n", creator->pid);
+    return ERROR;
+  }
+
+  if (PrepareUserWrite(pipe_idp, sizeof(int)) == ERROR)
+  {
+    return ERROR;
+  }
 
   pipe_t *pipe = malloc(sizeof(pipe_t));
   if (pipe == NULL)
@@ -337,7 +1412,6 @@ int PipeInit(int *pipe_idp)
     return ERROR;
   }
 
-  pipe->id = PIPE_ID_FLAG | next_sync_id++;
   pipe->read_queue = pcb_queue_create();
   if (pipe->read_queue == NULL)
   {
@@ -365,22 +1439,16 @@ int PipeInit(int *pipe_idp)
   // Also initialize the buffer itself (optional but good practice)
   memset(pipe->buffer, 0, PIPE_BUFFER_LEN);
 
-  pipe->next = NULL;
-  pipe->prev = NULL;
-
-  // Add to global list
-  if (global_pipes->head == NULL)
+  pipe->id = AllocSyncSlot(PIPE_ID_FLAG, pipe);
+  if (pipe->id == ERROR)
   {
-    global_pipes->head = pipe;
-    global_pipes->tail = pipe;
-  }
-  else
-  {
-    global_pipes->tail->next = pipe;
-    pipe->prev = global_pipes->tail;
-    global_pipes->tail = pipe;
+    free(pipe->write_queue);
+    free(pipe->read_queue);
+    free(pipe);
+    return ERROR;
   }
-  global_pipes->size++;
+  pipe->creator_pid = creator->pid;
+  creator->num_sync_objects++;
   *pipe_idp = pipe->id;
 
   TracePrintf(2, "PipeInit: Pipe initialized with id %d\n", pipe->id);
@@ -389,13 +1457,18 @@ int PipeInit(int *pipe_idp)
 
 int PipeRead(int pipe_id, void *buffer, int length)
 {
-  if (pipe_id <= 0 || buffer == NULL || length <= 0)
+  return PipeReadTimed(pipe_id, buffer, length, 0);
+}
+
+int PipeReadTimed(int pipe_id, void *buffer, int length, int ticks)
+{
+  if (pipe_id <= 0 || buffer == NULL || length <= 0 || ticks < 0)
   {
     TracePrintf(0, "PipeRead: Invalid arguments\n");
     return ERROR;
   }
 
-  pipe_t *pipe = FindPipe(pipe_id);
+  pipe_t *pipe = (pipe_t *)UseSyncSlot(pipe_id, PIPE_ID_FLAG);
   if (pipe == NULL)
   {
     TracePrintf(0, "PipeRead: Pipe %d not found\n", pipe_id);
@@ -412,9 +1485,9 @@ int PipeRead(int pipe_id, void *buffer, int length)
     TracePrintf(2, "PipeRead: Pipe empty, blocking reader (pid %d)\n", pcb->pid);
     pcb_enqueue(pipe->read_queue, pcb);
     pcb->state = PCB_STATE_BLOCKED;
-    pcb_enqueue(blocked_processes, pcb);
+    StartWaitTimeout(pcb, ticks);
 
-    pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+    pcb_t *next = PickNextProcess();
     int rc = KernelContextSwitch(KCSwitch, pcb, next);
     if (rc == -1)
     {
@@ -422,6 +1495,12 @@ int PipeRead(int pipe_id, void *buffer, int length)
       Halt();
     }
 
+    if (EndWaitTimeout(pcb))
+    {
+      TracePrintf(2, "PipeRead: Process %d timed out on pipe %d\n", pcb->pid, pipe_id);
+      return TIMEOUT;
+    }
+
     TracePrintf(2, "PipeRead: Process %d resumed after blocking\n", pcb->pid);
   }
 
@@ -435,6 +1514,12 @@ int PipeRead(int pipe_id, void *buffer, int length)
   // Determine how many bytes to read
   int bytes_to_read = (length < pipe->bytes_available) ? length : pipe->bytes_available;
 
+  // Merged pages in the destination need private copies before the kernel writes them
+  if (PrepareUserWrite(buffer, bytes_to_read) == ERROR)
+  {
+    return ERROR;
+  }
+
   // Read data from the circular buffer
   char *dst = (char *)buffer;
   for (int i = 0; i < bytes_to_read; i++)
@@ -480,13 +1565,14 @@ int PipeRead(int pipe_id, void *buffer, int length)
 
       // Wake up the writer
       pcb_t *writer = request->pcb;
+      writer->write_request = NULL;
       writer->state = PCB_STATE_READY;
-      pcb_remove(blocked_processes, writer);
-      pcb_enqueue(ready_processes, writer);
+      MakeReady(writer, SCHED_WOKEN);
 
       TracePrintf(2, "PipeRead: Woke up process %d after writing to pipe %d\n", writer->pid, pipe_id);
 
       // Free the request
+      free(request->buffer);
       free(request);
     }
     else
@@ -508,7 +1594,7 @@ int PipeWrite(int pipe_id, void *buffer, int length)
     return ERROR;
   }
 
-  pipe_t *pipe = FindPipe(pipe_id);
+  pipe_t *pipe = (pipe_t *)UseSyncSlot(pipe_id, PIPE_ID_FLAG);
   if (pipe == NULL)
   {
     return ERROR;
@@ -533,18 +1619,19 @@ int PipeWrite(int pipe_id, void *buffer, int length)
   pipe->bytes_available += bytes_to_write;
 
   // Wake up readers if we have data
+  pcb_t *reader = NULL;
   if (pipe->read_queue->head != NULL)
   {
-    pcb_t *reader = pcb_dequeue(pipe->read_queue);
+    reader = pcb_dequeue(pipe->read_queue);
     reader->state = PCB_STATE_READY;
-    pcb_remove(blocked_processes, reader);
-    pcb_enqueue(ready_processes, reader);
+    MakeReady(reader, SCHED_WOKEN);
     TracePrintf(2, "PipeWrite: Woke up reader process\n");
   }
 
   // If we wrote everything, we're done
   if (bytes_to_write == length)
   {
+    DirectedYield(reader);
     return length;
   }
 
@@ -570,6 +1657,7 @@ int PipeWrite(int pipe_id, void *buffer, int length)
   request->pcb = pcb;
   request->buffer = remaining_data; // Use our copy
   request->length = length - bytes_to_write;
+  request->queue = pipe->write_queue;
   request->next = NULL;
   request->prev = NULL;
 
@@ -588,10 +1676,10 @@ int PipeWrite(int pipe_id, void *buffer, int length)
   pipe->write_queue->size++;
 
   // Block until more space is available
+  pcb->write_request = request;
   pcb->state = PCB_STATE_BLOCKED;
-  pcb_enqueue(blocked_processes, pcb);
 
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+  pcb_t *next = PickNextProcess();
   int rc = KernelContextSwitch(KCSwitch, pcb, next);
   if (rc == -1)
   {
@@ -602,17 +1690,9 @@ int PipeWrite(int pipe_id, void *buffer, int length)
   return length;
 }
 
-int ReclaimLockHelper(lock_t *lock, int id)
+int ReclaimLockHelper(int id)
 {
-  while (lock != NULL)
-  {
-    if (lock->id == id)
-    {
-      break;
-    }
-    lock = lock->next;
-  }
-
+  lock_t *lock = FindLock(id);
   if (lock == NULL)
   {
     TracePrintf(0, "Lock %d not found, cannot reclaim\n", id);
@@ -625,166 +1705,159 @@ int ReclaimLockHelper(lock_t *lock, int id)
     return ERROR;
   }
 
-  if (lock->prev == NULL)
-  {
-    global_locks->head = lock->next;
-  }
-  else
-  {
-    lock->prev->next = lock->next;
-  }
-
-  if (lock->next == NULL)
-  {
-    global_locks->tail = lock->prev;
-  }
-  else
-  {
-    lock->next->prev = lock->prev;
-  }
-
+  FreeSyncSlot(id);
+  UnchargeSyncObject(lock->creator_pid);
   free(lock->wait_queue);
   free(lock);
-  global_locks->size--;
 
   return SUCCESS;
 }
 
-int ReclaimCondvarHelper(cond_t *condvar, int id)
+int ReclaimCondvarHelper(int id)
 {
-
-  while (condvar != NULL)
-  {
-    if (condvar->id == id)
-    {
-      break;
-    }
-    condvar = condvar->next;
-  }
-
+  cond_t *condvar = FindCondvar(id);
   if (condvar == NULL)
   {
     TracePrintf(0, "Condition variable %d not found, cannot reclaim\n", id);
     return ERROR;
   }
 
-  if (condvar->prev == NULL)
-  {
-    global_condvars->head = condvar->next;
-  }
-  else
-  {
-    condvar->prev->next = condvar->next;
-  }
-
-  if (condvar->next == NULL)
+  if (!pcb_queue_is_empty(condvar->wait_queue))
   {
-    global_condvars->tail = condvar->prev;
-  }
-  else
-  {
-    condvar->next->prev = condvar->prev;
+    TracePrintf(0, "Condition variable %d has waiters, cannot reclaim\n", id);
+    return ERROR;
   }
 
+  FreeSyncSlot(id);
+  UnchargeSyncObject(condvar->creator_pid);
   free(condvar->wait_queue);
   free(condvar);
-  global_condvars->size--;
 
   return SUCCESS;
 }
 
 lock_t *FindLock(int id)
 {
-  lock_t *lock = global_locks->head;
-  while (lock != NULL)
-  {
-    if (lock->id == id)
-    {
-      break;
-    }
-    lock = lock->next;
-  }
-  return lock;
+  return (lock_t *)LookupSyncSlot(id, LOCK_ID_FLAG);
 }
 
 cond_t *FindCondvar(int cvar_id)
 {
-  cond_t *condvar = global_condvars->head;
-  while (condvar != NULL)
-  {
-    if (condvar->id == cvar_id)
-    {
-      break;
-    }
-    condvar = condvar->next;
-  }
-  return condvar;
+  return (cond_t *)LookupSyncSlot(cvar_id, CONDVAR_ID_FLAG);
 }
 
 pipe_t *FindPipe(int pipe_id)
 {
-  pipe_t *pipe = global_pipes->head;
-  while (pipe != NULL)
-  {
-    if (pipe->id == pipe_id)
-    {
-      break;
-    }
-    pipe = pipe->next;
-  }
-  return pipe;
+  return (pipe_t *)LookupSyncSlot(pipe_id, PIPE_ID_FLAG);
+}
+
+rwlock_t *FindRWLock(int rwlock_id)
+{
+  return (rwlock_t *)LookupSyncSlot(rwlock_id, RWLOCK_ID_FLAG);
+}
+
+semaphore_t *FindSem(int sem_id)
+{
+  return (semaphore_t *)LookupSyncSlot(sem_id, SEM_ID_FLAG);
+}
+
+barrier_t *FindBarrier(int barrier_id)
+{
+  return (barrier_t *)LookupSyncSlot(barrier_id, BARRIER_ID_FLAG);
 }
 
-int ReclaimPipeHelper(pipe_t *pipe, int id)
+int ReclaimBarrierHelper(int id)
 {
-  while (pipe != NULL)
+  barrier_t *barrier = FindBarrier(id);
+  if (barrier == NULL)
   {
-    if (pipe->id == id)
-    {
-      break;
-    }
-    pipe = pipe->next;
+    TracePrintf(0, "Barrier %d not found, cannot reclaim\n", id);
+    return ERROR;
   }
 
-  if (pipe == NULL)
+  if (!pcb_queue_is_empty(barrier->wait_queue))
   {
-    TracePrintf(0, "Pipe %d not found, cannot reclaim\n", id);
+    TracePrintf(0, "Barrier %d has waiters, cannot reclaim\n", id);
     return ERROR;
   }
 
-  // Free any waiting writers
-  while (pipe->write_queue->head != NULL)
+  FreeSyncSlot(id);
+  UnchargeSyncObject(barrier->creator_pid);
+  free(barrier->wait_queue);
+  free(barrier);
+
+  return SUCCESS;
+}
+
+int ReclaimSemHelper(int id)
+{
+  semaphore_t *sem = FindSem(id);
+  if (sem == NULL)
   {
-    write_request_t *request = pipe->write_queue->head;
-    pipe->write_queue->head = request->next;
-    free(request);
+    TracePrintf(0, "Semaphore %d not found, cannot reclaim\n", id);
+    return ERROR;
   }
-  free(pipe->write_queue);
 
-  // Free read queue
-  free(pipe->read_queue);
+  if (!pcb_queue_is_empty(sem->wait_queue))
+  {
+    TracePrintf(0, "Semaphore %d has waiters, cannot reclaim\n", id);
+    return ERROR;
+  }
 
-  // Remove from linked list
-  if (pipe->prev == NULL)
+  FreeSyncSlot(id);
+  UnchargeSyncObject(sem->creator_pid);
+  free(sem->wait_queue);
+  free(sem);
+
+  return SUCCESS;
+}
+
+int ReclaimRWLockHelper(int id)
+{
+  rwlock_t *rwlock = FindRWLock(id);
+  if (rwlock == NULL)
   {
-    global_pipes->head = pipe->next;
+    TracePrintf(0, "Reader-writer lock %d not found, cannot reclaim\n", id);
+    return ERROR;
   }
-  else
+
+  if (rwlock->writer != NULL || rwlock->num_readers > 0)
   {
-    pipe->prev->next = pipe->next;
+    TracePrintf(0, "Reader-writer lock %d is held, cannot reclaim\n", id);
+    return ERROR;
   }
 
-  if (pipe->next == NULL)
+  FreeSyncSlot(id);
+  UnchargeSyncObject(rwlock->creator_pid);
+  free(rwlock->readers);
+  free(rwlock->read_queue);
+  free(rwlock->write_queue);
+  free(rwlock);
+
+  return SUCCESS;
+}
+
+int ReclaimPipeHelper(int id)
+{
+  pipe_t *pipe = FindPipe(id);
+  if (pipe == NULL)
   {
-    global_pipes->tail = pipe->prev;
+    TracePrintf(0, "Pipe %d not found, cannot reclaim\n", id);
+    return ERROR;
   }
-  else
+
+  if (!pcb_queue_is_empty(pipe->read_queue) || pipe->write_queue->head != NULL)
   {
-    pipe->next->prev = pipe->prev;
+    TracePrintf(0, "Pipe %d has blocked readers or writers, cannot reclaim\n", id);
+    return ERROR;
   }
 
+  free(pipe->write_queue);
+  free(pipe->read_queue);
+
+  FreeSyncSlot(id);
+  UnchargeSyncObject(pipe->creator_pid);
   free(pipe);
-  global_pipes->size--;
 
   return SUCCESS;
-}
\ No newline at end of file
+}
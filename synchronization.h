@@ -4,6 +4,22 @@
 #include "queue.h"
 #include "yalnix.h"
 
+/**
+ * Lock Profile structure - contention counters of one lock
+ *
+ * Counted only while lock profiling is on; SysLockProfile copies these out.
+ */
+typedef struct lock_profile
+{
+  int id;              // ID of the lock
+  int acquisitions;    // Times the lock was taken
+  int contended;       // Times a process had to queue for it
+  int wait_ticks;      // Clock ticks spent queued, summed over all waiters
+  int max_wait_ticks;  // Longest single wait in clock ticks
+  int hold_ticks;      // Clock ticks the lock was held, summed over all holds
+  int max_queue_depth; // Most processes ever queued at once
+} lock_profile_t;
+
 /**
  * Lock structure - represents a mutual exclusion lock
  */
@@ -13,8 +29,10 @@ typedef struct lock
   int id;                  // Unique identifier for this lock
   pcb_t *owner;            // Process that currently holds the lock
   pcb_queue_t *wait_queue; // Queue of processes waiting to acquire the lock
-  struct lock *next;       // Next lock in the global list
-  struct lock *prev;       // Previous lock in the global list
+  int creator_pid;         // Process charged for this lock
+  struct lock *next_held;  // Next lock held by the same owner
+  unsigned int held_since; // Clock tick the current owner took the lock
+  lock_profile_t profile;  // Contention counters
 } lock_t;
 
 /**
@@ -24,29 +42,49 @@ typedef struct cond
 {
   int id;                  // Unique identifier for this condition variable
   pcb_queue_t *wait_queue; // Queue of processes waiting on this condition
-  struct cond *next;       // Next condition variable in the global list
-  struct cond *prev;       // Previous condition variable in the global list
+  int creator_pid;         // Process charged for this condition variable
 } cond_t;
 
 /**
- * Lock List structure - maintains a linked list of all locks
+ * Reader-Writer Lock structure - shared readers or one exclusive writer
+ *
+ * Phase-fair: a waiting writer holds back new readers, and when a writer
+ * releases, every reader queued so far is admitted before the next writer.
+ */
+typedef struct rwlock
+{
+  int id;                   // Unique identifier for this lock
+  pcb_t *writer;            // Process holding the lock for writing, NULL if none
+  pcb_t **readers;          // Processes holding the lock for reading
+  int num_readers;          // Number of entries in readers
+  int readers_capacity;     // Allocated size of readers
+  pcb_queue_t *read_queue;  // Processes waiting to read
+  pcb_queue_t *write_queue; // Processes waiting to write
+  int creator_pid;          // Process charged for this lock
+} rwlock_t;
+
+/**
+ * Semaphore structure - counting semaphore with a FIFO wait queue
  */
-typedef struct lock_list
+typedef struct semaphore
 {
-  lock_t *head; // First lock in the list
-  lock_t *tail; // Last lock in the list
-  int size;     // Number of locks in the list
-} lock_list_t;
+  int id;                  // Unique identifier for this semaphore
+  int count;               // Units available to SysSemDown without blocking
+  pcb_queue_t *wait_queue; // Processes waiting for a unit, in arrival order
+  int creator_pid;         // Process charged for this semaphore
+} semaphore_t;
 
 /**
- * Condition Variable List structure - maintains a linked list of all condition variables
+ * Barrier structure - blocks a fixed number of processes until all arrive
  */
-typedef struct cond_list
+typedef struct barrier
 {
-  cond_t *head; // First condition variable in the list
-  cond_t *tail; // Last condition variable in the list
-  int size;     // Number of condition variables in the list
-} cond_list_t;
+  int id;                  // Unique identifier for this barrier
+  int parties;             // Processes that must arrive to open the barrier
+  int arrived;             // Processes that have arrived in the current phase
+  pcb_queue_t *wait_queue; // Processes waiting for the rest of the phase
+  int creator_pid;         // Process charged for this barrier
+} barrier_t;
 
 /**
  * Write Request structure - for pipe write operations
@@ -56,6 +94,7 @@ typedef struct write_request
   pcb_t *pcb;                 // Process making the write request
   void *buffer;               // Buffer containing data to write
   int length;                 // Length of data to write
+  struct write_queue *queue;  // Write queue the request is waiting on
   struct write_request *next; // Next write request in queue
   struct write_request *prev; // Previous write request in queue
 } write_request_t;
@@ -84,40 +123,70 @@ typedef struct pipe
   int read_index;               // Current read position in buffer
   int write_index;              // Current write position in buffer
   int bytes_available;          // Number of bytes available to read
-
-  struct pipe *next; // Next pipe in the global list
-  struct pipe *prev; // Previous pipe in the global list
+  int creator_pid;              // Process charged for this pipe
 } pipe_t;
 
 /**
- * Pipe List structure - maintains a linked list of all pipes
+ * Sync Slot structure - one entry of the synchronization object table
+ *
+ * An object's ID is its type flag, its slot index and the slot's
+ * generation at creation. Freeing a slot bumps the generation, so IDs of
+ * reclaimed objects stop matching even after the slot is reused.
  */
-typedef struct pipe_list
+typedef struct sync_slot
 {
-  pipe_t *head; // First pipe in the list
-  pipe_t *tail; // Last pipe in the list
-  int size;     // Number of pipes in the list
-} pipe_list_t;
+  int type;       // Type flag of the object in the slot, 0 if the slot is free
+  int generation; // Incremented each time the slot is freed
+  void *object;   // The lock, condition variable or pipe
+  int next_free;  // Next free slot when this one is free, -1 at the end
+
+  int refs;          // Live processes that created, used or inherited the object
+  int last_user_pid; // Process known to hold a reference, so repeat use skips the lookup
+} sync_slot_t;
 
 // Type identification flags for synchronization objects
 #define LOCK_ID_FLAG 0x10000    // Bit 16 set for locks
 #define CONDVAR_ID_FLAG 0x20000 // Bit 17 set for condition variables
 #define PIPE_ID_FLAG 0x30000    // Bits 16-17 set for pipes
-#define TYPE_MASK 0xF0000       // Mask to extract type
-#define ID_MASK 0x0FFFF         // Mask to extract actual ID (supports 65535 IDs per type)
+#define RWLOCK_ID_FLAG 0x40000  // Bit 18 set for reader-writer locks
+#define SEM_ID_FLAG 0x50000     // Bits 16 and 18 set for semaphores
+#define BARRIER_ID_FLAG 0x60000 // Bits 17-18 set for barriers
+#define TYPE_MASK 0xF0000       // Mask to extract type (bits 16-19)
+#define SLOT_MASK 0x0FFFF       // Mask to extract the slot index (bits 0-15)
+#define GENERATION_SHIFT 20     // Slot generation lives in bits 20-30
+#define GENERATION_MASK 0x7FF   // Generation bits after shifting; bit 31 stays clear so IDs are positive
+
+#define SYNC_INITIAL_SLOTS 64          // Initial size of the object table
+#define SYNC_MAX_SLOTS (SLOT_MASK + 1) // Largest the object table may grow
+#define SYNC_INITIAL_REFS 8            // Initial size of a process's list of referenced objects
+
+#define PI_MAX_DEPTH 8 // Most lock owners a priority boost is passed through
+
+#define TIMEOUT (-3) // Returned by a timed wait that expired before it was satisfied
+
+#define LOCK_PROFILE_MAX 64 // Most locks one SysLockProfile call reports
 
 // Helper macros for ID manipulation
-#define GET_RAW_ID(id) ((id) & ID_MASK)
+#define GET_SLOT(id) ((id) & SLOT_MASK)
 #define GET_TYPE(id) ((id) & TYPE_MASK)
+#define GET_GENERATION(id) (((id) >> GENERATION_SHIFT) & GENERATION_MASK)
+#define MAKE_SYNC_ID(type, slot, generation) \
+  (((generation) << GENERATION_SHIFT) | (type) | (slot))
 #define IS_LOCK(id) (GET_TYPE(id) == LOCK_ID_FLAG)
 #define IS_CONDVAR(id) (GET_TYPE(id) == CONDVAR_ID_FLAG)
 #define IS_PIPE(id) (GET_TYPE(id) == PIPE_ID_FLAG)
+#define IS_RWLOCK(id) (GET_TYPE(id) == RWLOCK_ID_FLAG)
+#define IS_SEM(id) (GET_TYPE(id) == SEM_ID_FLAG)
+#define IS_BARRIER(id) (GET_TYPE(id) == BARRIER_ID_FLAG)
+
+#define BARRIER_SERIAL 1 // BarrierWait result for the one process chosen per phase
 
 /**
  * InitSyncLists - Initialize the synchronization subsystem
  *
- * Allocates and initializes the global lists for locks, condition
- * variables, and pipes.
+ * Allocates the object table shared by locks, condition variables, and
+ * pipes. The table doubles when it fills, up
+ * to SYNC_MAX_SLOTS.
  *
  * Note: Halts the system if memory allocation fails
  */
@@ -138,7 +207,9 @@ int LockInit(int *lock_idp);
  * Acquire - Acquire a lock
  *
  * Attempts to acquire the specified lock. If the lock is already held,
- * blocks the calling process until the lock becomes available.
+ * blocks the calling process until the lock becomes available. While it
+ * waits, the owner (and whatever the owner is waiting on, up to
+ * PI_MAX_DEPTH owners) runs at no worse than the caller's priority.
  *
  * @param lock_id - ID of the lock to acquire
  *
@@ -148,11 +219,24 @@ int LockInit(int *lock_idp);
  */
 int Acquire(int lock_id);
 
+/**
+ * AcquireTimed - Acquire a lock, giving up after a number of clock ticks
+ *
+ * @param lock_id - ID of the lock to acquire
+ * @param ticks - Most clock ticks to wait, 0 to wait forever
+ *
+ * @return SUCCESS on successful acquisition,
+ *         TIMEOUT if the lock was not handed over in time,
+ *         ERROR if lock_id or ticks is invalid
+ */
+int AcquireTimed(int lock_id, int ticks);
+
 /**
  * Release - Release a lock
  *
  * Releases a previously acquired lock and wakes up the next
- * waiting process, if any.
+ * waiting process, if any. Any priority the caller inherited through the
+ * lock is given up.
  *
  * @param lock_id - ID of the lock to release
  *
@@ -161,6 +245,107 @@ int Acquire(int lock_id);
  */
 int Release(int lock_id);
 
+/**
+ * HandOffLock - Release a lock on behalf of its owner
+ *
+ * Clears the owner and, if any process is waiting, transfers the lock
+ * to the first waiter and makes it ready. Does not check who is calling.
+ *
+ * @param lock - Pointer to the held lock
+ */
+void HandOffLock(lock_t *lock);
+
+/**
+ * ReleaseLocksHeldBy - Release every lock held by a process
+ *
+ * Each lock the process holds is handed to the next waiter instead of
+ * staying locked forever.
+ *
+ * @param pcb - Pointer to the process whose locks to release
+ */
+void ReleaseLocksHeldBy(pcb_t *pcb);
+
+/**
+ * ReleaseSyncObjects - Clean up the synchronization state of an exiting process
+ *
+ * Hands every lock and reader-writer lock hold to the next waiter, then
+ * drops the process's references. An object is reclaimed once no live
+ * process that created, used or inherited it remains. An ID that was
+ * passed on but never used by a surviving process stops working, as if
+ * the last user had called Reclaim.
+ *
+ * @param pcb - The exiting process, which must not be on any wait queue
+ */
+void ReleaseSyncObjects(pcb_t *pcb);
+
+/**
+ * InheritSyncRefs - Give a new child a reference to every object its parent references
+ *
+ * The child starts with a copy of the parent's memory and so knows every
+ * ID the parent knows.
+ *
+ * @param child - The new process, which must not reference anything yet
+ * @param parent - The forking process
+ *
+ * @return SUCCESS on success, ERROR if memory allocation fails, in which case the child references nothing
+ */
+int InheritSyncRefs(pcb_t *child, pcb_t *parent);
+
+/**
+ * SetBasePriority - Change the priority a process has of its own
+ *
+ * The process runs at the better of this and any priority inherited from
+ * waiters on locks it holds. If it is itself waiting on a lock, the change
+ * is passed on to the lock's owner.
+ *
+ * @param pcb - The process
+ * @param priority - New base priority, 0 (highest) to PRIO_LEVELS - 1
+ */
+void SetBasePriority(pcb_t *pcb, int priority);
+
+/**
+ * CancelSyncWait - Undo the side effects of a wait a process was pulled out of
+ *
+ * The caller must already have removed the process from the object's wait
+ * queue. Drops any priority the process lent a lock owner, takes it off a
+ * barrier's arrival count, and lets readers held back by a departed writer
+ * proceed.
+ *
+ * @param pcb - The process
+ */
+void CancelSyncWait(pcb_t *pcb);
+
+/**
+ * SetLockProfiling - Turn lock contention counting on or off
+ *
+ * When off, lock operations skip the counters entirely.
+ *
+ * @param enabled - Nonzero to count
+ */
+void SetLockProfiling(int enabled);
+
+/**
+ * SysLockProfile - Control lock profiling and report the most contended locks
+ *
+ * @param enable - 1 to turn profiling on, 0 to turn it off, negative to leave it unchanged
+ * @param stats - Region 1 array that receives the profiles, or NULL
+ * @param count - Size of the stats array; at most LOCK_PROFILE_MAX entries are filled
+ *
+ * @return Number of profiles written, most contended first (ties broken by
+ *         total wait), ERROR if count is negative or stats cannot be written
+ */
+int SysLockProfile(int enable, lock_profile_t *stats, int count);
+
+/**
+ * CancelPipeWrite - Drop the pending pipe write of a blocked writer
+ *
+ * Unlinks the writer's request from the pipe's write queue and frees it.
+ * Does nothing if the process has no pending write.
+ *
+ * @param pcb - Pointer to the writer process
+ */
+void CancelPipeWrite(pcb_t *pcb);
+
 /**
  * CvarInit - Initialize a new condition variable
  *
@@ -183,15 +368,33 @@ int CvarInit(int *cvar_id);
  * @param lock_id - ID of the lock to release while waiting
  *
  * @return SUCCESS on successful wait and wake-up,
- *         ERROR if cvar_id or lock_id is invalid or doesn't exist,
+ *         ERROR if cvar_id or lock_id is invalid or doesn't exist, or the caller does not hold the lock,
  *         will halt the system if context switch fails
  */
 int CvarWait(int cvar_id, int lock_id);
 
+/**
+ * CvarWaitTimed - Wait on a condition variable, giving up after a number of clock ticks
+ *
+ * The lock is held again when this returns, whether or not it timed out.
+ * Once signalled the wait no longer times out, even if the lock is not free yet.
+ *
+ * @param cvar_id - ID of the condition variable to wait on
+ * @param lock_id - ID of the lock to release while waiting
+ * @param ticks - Most clock ticks to wait, 0 to wait forever
+ *
+ * @return SUCCESS if signaled, TIMEOUT if no signal arrived in time,
+ *         ERROR if an ID or ticks is invalid, the caller does not hold the lock, or the lock
+ *         could not be taken back, in which case the caller no longer holds it
+ */
+int CvarWaitTimed(int cvar_id, int lock_id, int ticks);
+
 /**
  * CvarSignal - Signal a condition variable
  *
  * Wakes up one process waiting on the specified condition variable.
+ * If the waiter's lock is held, the waiter is moved straight onto the
+ * lock's wait queue and becomes ready only when the lock is handed to it.
  * If no processes are waiting, this is a no-op.
  *
  * @param cvar_id - ID of the condition variable to signal
@@ -205,7 +408,9 @@ int CvarSignal(int cvar_id);
  * CvarBroadcast - Broadcast to a condition variable
  *
  * Wakes up all processes waiting on the specified condition variable.
- * If no processes are waiting, this is a no-op.
+ * Waiters whose lock is held are moved onto the lock's wait queue, so at
+ * most one of them becomes ready instead of all of them waking to block
+ * again. If no processes are waiting, this is a no-op.
  *
  * @param cvar_id - ID of the condition variable to broadcast to
  *
@@ -214,93 +419,295 @@ int CvarSignal(int cvar_id);
  */
 int CvarBroadcast(int cvar_id);
 
+/**
+ * PipeReadTimed - Read from a pipe, giving up after a number of clock ticks
+ *
+ * @param pipe_id - ID of the pipe
+ * @param buffer - Region 1 buffer that receives the data
+ * @param length - Most bytes to read
+ * @param ticks - Most clock ticks to wait for data, 0 to wait forever
+ *
+ * @return Number of bytes read, TIMEOUT if the pipe stayed empty,
+ *         ERROR if the arguments are invalid
+ */
+int PipeReadTimed(int pipe_id, void *buffer, int length, int ticks);
+
+/**
+ * StartWaitTimeout - Arm the timeout of a wait the process is about to block in
+ *
+ * Call after queueing the process on the object's wait queue. If the
+ * timer fires first, the process is taken off that queue and made ready.
+ *
+ * @param pcb - The process about to block
+ * @param ticks - Most clock ticks to wait, 0 for no timeout
+ */
+void StartWaitTimeout(pcb_t *pcb, int ticks);
+
+/**
+ * EndWaitTimeout - Disarm a wait timeout after the process wakes up
+ *
+ * @param pcb - The process that was woken
+ *
+ * @return 1 if the wait timed out, 0 if it was satisfied
+ */
+int EndWaitTimeout(pcb_t *pcb);
+
+/**
+ * RWLockInit - Initialize a new reader-writer lock
+ *
+ * @param rwlock_idp - Pointer to store the lock ID
+ *
+ * @return SUCCESS on successful initialization, ERROR if rwlock_idp is NULL or memory allocation fails
+ */
+int RWLockInit(int *rwlock_idp);
+
+/**
+ * AcquireRead - Acquire a reader-writer lock for reading
+ *
+ * Admits the caller alongside other readers unless a writer holds the
+ * lock or is waiting for it; otherwise blocks until the writer phase ends.
+ *
+ * @param rwlock_id - ID of the lock
+ *
+ * @return SUCCESS once the caller holds the lock for reading, ERROR if the ID is invalid
+ */
+int AcquireRead(int rwlock_id);
+
+/**
+ * AcquireWrite - Acquire a reader-writer lock for writing
+ *
+ * Blocks until no reader or writer holds the lock.
+ *
+ * @param rwlock_id - ID of the lock
+ *
+ * @return SUCCESS once the caller holds the lock exclusively, ERROR if the ID is invalid
+ */
+int AcquireWrite(int rwlock_id);
+
+/**
+ * ReleaseRW - Release a reader-writer lock
+ *
+ * Releases the caller's read or write hold. When a writer releases, all
+ * queued readers are admitted in one pass; when the last reader releases,
+ * the first queued writer gets the lock.
+ *
+ * @param rwlock_id - ID of the lock
+ *
+ * @return SUCCESS on success, ERROR if the ID is invalid or the caller does not hold the lock
+ */
+int ReleaseRW(int rwlock_id);
+
+/**
+ * SysSemInit - Initialize a new counting semaphore
+ *
+ * @param sem_idp - Pointer to store the semaphore ID
+ * @param count - Initial number of units, at least 0
+ *
+ * @return SUCCESS on successful initialization,
+ *         ERROR if sem_idp is NULL, count is negative or memory allocation fails
+ */
+int SysSemInit(int *sem_idp, int count);
+
+/**
+ * SysSemDown - Take one unit from a semaphore
+ *
+ * Blocks in FIFO order until a unit is available.
+ *
+ * @param sem_id - ID of the semaphore
+ *
+ * @return SUCCESS once the caller has its unit, ERROR if the ID is invalid
+ */
+int SysSemDown(int sem_id);
+
+/**
+ * SysSemUp - Return units to a semaphore
+ *
+ * Each unit goes straight to the longest waiter if there is one, so up to
+ * count waiters are woken by one call.
+ *
+ * @param sem_id - ID of the semaphore
+ * @param count - Number of units to add, at least 1
+ *
+ * @return SUCCESS on success, ERROR if the ID or count is invalid
+ */
+int SysSemUp(int sem_id, int count);
+
+/**
+ * BarrierInit - Initialize a new barrier
+ *
+ * @param barrier_idp - Pointer to store the barrier ID
+ * @param parties - Number of processes that must call BarrierWait each phase, at least 1
+ *
+ * @return SUCCESS on successful initialization,
+ *         ERROR if barrier_idp is NULL, parties is less than 1 or memory allocation fails
+ */
+int BarrierInit(int *barrier_idp, int parties);
+
+/**
+ * BarrierWait - Wait at a barrier until every party has arrived
+ *
+ * The last process to arrive makes all the others ready in one pass and
+ * starts the next phase without blocking.
+ *
+ * @param barrier_id - ID of the barrier
+ *
+ * @return BARRIER_SERIAL in the last arriver, which is the phase's serial process,
+ *         0 in every other process, ERROR if the ID is invalid
+ */
+int BarrierWait(int barrier_id);
+
 /**
  * Reclaim - Reclaim a synchronization object
  *
  * Deallocates the specified synchronization object (lock, condition variable,
- * or pipe) and removes it from the global list.
+ * pipe, reader-writer lock, semaphore, or barrier) and frees its slot in the
+ * object table.
  *
  * @param resource_id - ID of the synchronization object to reclaim
  *
  * @return SUCCESS on successful reclamation,
  *         ERROR if resource_id is invalid or the object doesn't exist,
- *         ERROR for locks if the lock is currently held by a process
+ *         ERROR for locks and reader-writer locks that are currently held,
+ *         ERROR for semaphores and barriers that processes are waiting on
  */
 int Reclaim(int resource_id);
 
 /**
  * ReclaimLockHelper - Helper function to reclaim a lock
  *
- * Removes a lock from the global lock list and frees its resources.
+ * Frees a lock's slot and its resources.
  *
- * @param lock - Pointer to the first lock in the list to search
  * @param id - ID of the lock to reclaim
  *
  * @return SUCCESS on successful reclamation,
  *         ERROR if the lock doesn't exist or is currently locked
  */
-int ReclaimLockHelper(lock_t *lock, int id);
+int ReclaimLockHelper(int id);
 
 /**
  * ReclaimCondvarHelper - Helper function to reclaim a condition variable
  *
- * Removes a condition variable from the global condition variable list
- * and frees its resources.
+ * Frees a condition variable's slot and its resources.
  *
- * @param condvar - Pointer to the first condition variable in the list to search
  * @param id - ID of the condition variable to reclaim
  *
  * @return SUCCESS on successful reclamation,
- *         ERROR if the condition variable doesn't exist
+ *         ERROR if the condition variable doesn't exist or has waiters
  */
-int ReclaimCondvarHelper(cond_t *condvar, int id);
+int ReclaimCondvarHelper(int id);
 
 /**
  * ReclaimPipeHelper - Helper function to reclaim a pipe
  *
- * Removes a pipe from the global pipe list, frees any pending
- * write requests, and frees all pipe resources.
+ * Frees a pipe's slot and all pipe resources.
  *
- * @param pipe - Pointer to the first pipe in the list to search
  * @param id - ID of the pipe to reclaim
  *
  * @return SUCCESS on successful reclamation,
- *         ERROR if the pipe doesn't exist
+ *         ERROR if the pipe doesn't exist or has blocked readers or writers
+ */
+int ReclaimPipeHelper(int id);
+
+/**
+ * ReclaimRWLockHelper - Helper function to reclaim a reader-writer lock
+ *
+ * Frees a reader-writer lock's slot and its resources.
+ *
+ * @param id - ID of the lock to reclaim
+ *
+ * @return SUCCESS on successful reclamation,
+ *         ERROR if the lock doesn't exist or is currently held
+ */
+int ReclaimRWLockHelper(int id);
+
+/**
+ * ReclaimSemHelper - Helper function to reclaim a semaphore
+ *
+ * Frees a semaphore's slot and its resources.
+ *
+ * @param id - ID of the semaphore to reclaim
+ *
+ * @return SUCCESS on successful reclamation,
+ *         ERROR if the semaphore doesn't exist or has waiters
+ */
+int ReclaimSemHelper(int id);
+
+/**
+ * ReclaimBarrierHelper - Helper function to reclaim a barrier
+ *
+ * Frees a barrier's slot and its resources.
+ *
+ * @param id - ID of the barrier to reclaim
+ *
+ * @return SUCCESS on successful reclamation,
+ *         ERROR if the barrier doesn't exist or has waiters
  */
-int ReclaimPipeHelper(pipe_t *pipe, int id);
+int ReclaimBarrierHelper(int id);
 
 /**
  * FindLock - Find a lock by ID
  *
- * Searches the global lock list for a lock with the specified ID.
+ * Looks the ID up in the object table in constant time.
  *
  * @param lock_id - ID of the lock to find
  *
- * @return Pointer to the lock if found, NULL if not found
+ * @return Pointer to the lock if found, NULL if not found or the ID is stale
  */
 lock_t *FindLock(int lock_id);
 
 /**
  * FindCondvar - Find a condition variable by ID
  *
- * Searches the global condition variable list for a condition variable
- * with the specified ID.
+ * Looks the ID up in the object table in constant time.
  *
  * @param condvar_id - ID of the condition variable to find
  *
- * @return Pointer to the condition variable if found, NULL if not found
+ * @return Pointer to the condition variable if found, NULL if not found or the ID is stale
  */
 cond_t *FindCondvar(int condvar_id);
 
 /**
  * FindPipe - Find a pipe by ID
  *
- * Searches the global pipe list for a pipe with the specified ID.
+ * Looks the ID up in the object table in constant time.
  *
  * @param pipe_id - ID of the pipe to find
  *
- * @return Pointer to the pipe if found, NULL if not found
+ * @return Pointer to the pipe if found, NULL if not found or the ID is stale
  */
 pipe_t *FindPipe(int pipe_id);
 
+/**
+ * FindRWLock - Find a reader-writer lock by ID
+ *
+ * Looks the ID up in the object table in constant time.
+ *
+ * @param rwlock_id - ID of the lock to find
+ *
+ * @return Pointer to the lock if found, NULL if not found or the ID is stale
+ */
+rwlock_t *FindRWLock(int rwlock_id);
+
+/**
+ * FindSem - Find a semaphore by ID
+ *
+ * Looks the ID up in the object table in constant time.
+ *
+ * @param sem_id - ID of the semaphore to find
+ *
+ * @return Pointer to the semaphore if found, NULL if not found or the ID is stale
+ */
+semaphore_t *FindSem(int sem_id);
+
+/**
+ * FindBarrier - Find a barrier by ID
+ *
+ * Looks the ID up in the object table in constant time.
+ *
+ * @param barrier_id - ID of the barrier to find
+ *
+ * @return Pointer to the barrier if found, NULL if not found or the ID is stale
+ */
+barrier_t *FindBarrier(int barrier_id);
+
 #endif // SYNCHRONIZATION_H
@@ -6,47 +6,181 @@
 #include "syscalls.h"
 #include "process.h"
 #include "synchronization.h"
+#include "tty.h"
+#include "merge.h"
+#include "scheduler.h"
+#include "timer.h"
+
+/*
+ * HandToParent - Puts an exited process on its parent's zombie queue and
+ * wakes the parent if it is blocked in Wait
+ */
+static void HandToParent(pcb_t *pcb)
+{
+  pcb_t *parent = pcb->parent;
+  pcb_enqueue(parent->zombies, pcb);
+  if (parent->waiting_for_child)
+  {
+    parent->waiting_for_child = 0;
+    parent->state = PCB_STATE_READY;
+    MakeReady(parent, SCHED_WOKEN);
+  }
+}
+
+/*
+ * ReleaseProcessState - Detaches a dying process from everything that could still reach it.
+ * Shared by Exit and Kill: takes it off the ready or wait queue it is on, marks it defunct,
+ * drops its pending timer, pipe and terminal requests, and releases or reclaims its
+ * synchronization objects.
+ */
+static void ReleaseProcessState(pcb_t *pcb)
+{
+  // A PCB is on at most one queue: ready, or the wait queue of a lock, condition variable,
+  // pipe reader, semaphore, barrier or terminal. Delayed processes sit in the timer wheel.
+  if (pcb->state == PCB_STATE_READY)
+  {
+    SchedRemove(pcb);
+  }
+  else if (pcb->queue != NULL)
+  {
+    pcb_remove(pcb->queue, pcb);
+    CancelSyncWait(pcb);
+  }
+
+  // From here on nothing may requeue it: handing off its locks recomputes its
+  // priority, and SetPriority requeues any process it still sees as ready
+  pcb->state = PCB_STATE_DEFUNCT;
+
+  CancelTimer(pcb);
+  CancelPipeWrite(pcb);
+  CancelTtyWrite(pcb);
+  ReleaseSyncObjects(pcb);
+  LeaveRealTime(pcb);
+}
+
+/*
+ * DiscardChildren - Frees children a failed ForkN already created, dropping the
+ * object references they inherited
+ */
+static void DiscardChildren(pcb_t **children, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    ReleaseSyncObjects(children[i]);
+    DestroyPCB(children[i]);
+  }
+}
 
 int SysFork(UserContext *uctxt)
+{
+  int pid;
+  int rc = SysForkN(uctxt, 1, &pid);
+  if (rc == ERROR)
+  {
+    return ERROR;
+  }
+  // The child gets back its index, 0; the parent gets the count, 1
+  return rc == 0 ? 0 : pid;
+}
+
+int SysForkN(UserContext *uctxt, int n, int *pids)
 {
   pcb_t *current_pcb = GetCurrentProcess();
-  pcb_t *new_pcb = CreatePCB("fork_child");
-  new_pcb->parent = current_pcb;
+  if (n <= 0 || n > FORKN_MAX)
+  {
+    return ERROR;
+  }
+  if (IsOverLimit(current_pcb, LIMIT_CHILDREN, current_pcb->num_children + n - 1))
+  {
+    TracePrintf(0, "SysForkN: Process %d cannot add %d children\n", current_pcb->pid, n);
+    return ERROR;
+  }
 
-  // Copy the user context passed from the trap handler into the new child PCB
-  memcpy(&new_pcb->user_context, uctxt, sizeof(UserContext));
+  // All or nothing: the PIDs are stored after the children exist, so split a merged
+  // pids buffer now, while failing still leaves nothing to undo
+  if (PrepareUserWrite(pids, n * sizeof(int)) == ERROR)
+  {
+    TracePrintf(0, "SysForkN: Cannot write the PIDs of %d children\n", n);
+    return ERROR;
+  }
 
-  // Copy the page table content from the parent to the child, allocating new frames for the child
-  CopyPageTable(current_pcb, new_pcb);
+  // Make sure every child's pages and kernel stack fit before creating any
+  int frames_needed = n * (CountValidPages(current_pcb) + KSTACK_PAGES);
+  if (frames_needed > NumFreeFrames())
+  {
+    TracePrintf(0, "SysForkN: Need %d frames, only %d free\n", frames_needed, NumFreeFrames());
+    return ERROR;
+  }
 
-  // Context switch to the child
-  int rc = KernelContextSwitch(KCCopy, new_pcb, NULL);
+  pcb_t *children[FORKN_MAX];
+  for (int i = 0; i < n; i++)
+  {
+    children[i] = CreatePCB("fork_child");
+    if (children[i] == NULL)
+    {
+      DiscardChildren(children, i);
+      return ERROR;
+    }
+
+    // The child knows every object ID the parent knows
+    if (InheritSyncRefs(children[i], current_pcb) == ERROR)
+    {
+      DiscardChildren(children, i + 1);
+      return ERROR;
+    }
+
+    // Children inherit the parent's resource limits, priority, hint and scheduling group
+    memcpy(children[i]->limits, current_pcb->limits, sizeof(children[i]->limits));
+    children[i]->priority = current_pcb->base_priority;
+    children[i]->base_priority = current_pcb->base_priority;
+    children[i]->sched_hint = current_pcb->sched_hint;
+    children[i]->sched_group = current_pcb->sched_group;
+
+    // Copy the user context passed from the trap handler into the new child PCB
+    memcpy(&children[i]->user_context, uctxt, sizeof(UserContext));
+  }
+
+  // Copy the page table content from the parent to the children, allocating new frames for each
+  if (CopyPageTable(current_pcb, children, n) == ERROR)
+  {
+    DiscardChildren(children, n);
+    return ERROR;
+  }
+
+  // One context switch copies the kernel stack into every child
+  int rc = KernelContextSwitch(KCCopyN, children, (void *)(long)n);
   if (rc == -1)
   {
     TracePrintf(0, "KernelContextSwitch failed when forking\n");
     Halt();
   }
 
-  // After context switch, check if we're in the child context
-  if (GetCurrentProcess()->pid == new_pcb->pid)
+  // After context switch, check if we're in one of the children
+  pcb_t *self = GetCurrentProcess();
+  for (int i = 0; i < n; i++)
   {
-    // We're in the child
-    WriteRegister(REG_PTBR1, (unsigned int)new_pcb->page_table);
-    WriteRegister(REG_TLB_FLUSH, TLB_FLUSH_ALL);
-    return 0;
+    if (self == children[i])
+    {
+      // We're in the child
+      WriteRegister(REG_PTBR1, (unsigned int)self->page_table);
+      WriteRegister(REG_TLB_FLUSH, TLB_FLUSH_ALL);
+      return i;
+    }
   }
-  else
+
+  // We're in the parent
+  for (int i = 0; i < n; i++)
   {
-    // We're in the parent
-    pcb_enqueue(ready_processes, new_pcb);
-    pcb_enqueue(current_pcb->children, new_pcb);
+    MakeReady(children[i], SCHED_NEW);
+    AddChild(current_pcb, children[i]);
+    pids[i] = children[i]->pid;
+  }
 
-    // Make sure the parent's page table is correctly set
-    WriteRegister(REG_PTBR1, (unsigned int)current_pcb->page_table);
-    WriteRegister(REG_TLB_FLUSH, TLB_FLUSH_ALL);
+  // Make sure the parent's page table is correctly set
+  WriteRegister(REG_PTBR1, (unsigned int)current_pcb->page_table);
+  WriteRegister(REG_TLB_FLUSH, TLB_FLUSH_ALL);
 
-    return new_pcb->pid;
-  }
+  return n;
 }
 
 int SysExec(char *filename, char *argvec[])
@@ -70,20 +204,25 @@ void SysExit(int status)
     Halt();
   }
 
-  pcb_enqueue(defunct_processes, pcb);
+  ReleaseProcessState(pcb);
   pcb->exit_status = status;
 
-  // First wake up the waiting parent
-  pcb_t *parent = pcb->parent;
-  if (parent && pcb_in_queue(waiting_parent_processes, parent))
+  // Free orphans that exited earlier, then detach our own children
+  ReapOrphans();
+  ReleaseChildren(pcb);
+
+  // Hand ourselves to the parent, waking it directly if it is blocked in Wait
+  if (pcb->parent != NULL)
   {
-    pcb_remove(waiting_parent_processes, parent);
-    parent->state = PCB_STATE_READY;
-    pcb_enqueue(ready_processes, parent);
+    HandToParent(pcb);
+  }
+  else
+  {
+    pcb_enqueue(defunct_processes, pcb);
   }
 
   // Then do context switch
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+  pcb_t *next = PickNextProcess();
   int rc = KernelContextSwitch(KCSwitch, pcb, next);
 
   if (rc == -1)
@@ -96,48 +235,43 @@ void SysExit(int status)
 int SysWait(int *status_ptr)
 {
   pcb_t *current_pcb = GetCurrentProcess();
-  if (current_pcb->children->head == NULL)
+  if (current_pcb->num_children == 0)
   {
     TracePrintf(0, "No children to wait for\n");
     return ERROR;
   }
-  for (pcb_t *pcb = defunct_processes->head; pcb != NULL; pcb = pcb->next)
+
+  // Block until one of our children exits; SysExit wakes us directly
+  if (pcb_queue_is_empty(current_pcb->zombies))
   {
-    if (pcb->parent->pid == current_pcb->pid)
+    current_pcb->waiting_for_child = 1;
+    current_pcb->state = PCB_STATE_BLOCKED;
+    pcb_t *next = PickNextProcess();
+    int rc = KernelContextSwitch(KCSwitch, current_pcb, next);
+    if (rc == -1)
     {
-      *status_ptr = pcb->exit_status;
-      pcb_remove(defunct_processes, pcb);
-      pcb_remove(current_pcb->children, pcb);
-      int pid = pcb->pid;
-      DestroyPCB(pcb);
-      return pid;
+      TracePrintf(0, "KernelContextSwitch failed when waiting\n");
+      Halt();
     }
   }
-  pcb_enqueue(waiting_parent_processes, current_pcb);
-  current_pcb->state = PCB_STATE_BLOCKED;
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
-  int rc = KernelContextSwitch(KCSwitch, current_pcb, next);
-  if (rc == -1)
+
+  pcb_t *child = pcb_dequeue(current_pcb->zombies);
+  if (child == NULL)
   {
-    TracePrintf(0, "KernelContextSwitch failed when waiting\n");
-    Halt();
+    return ERROR;
   }
 
-  for (pcb_t *pcb = defunct_processes->head; pcb != NULL; pcb = pcb->next)
+  TracePrintf(0, "parent pid: %d, child pid: %d\n", current_pcb->pid, child->pid);
+  if (PrepareUserWrite(status_ptr, sizeof(int)) == ERROR)
   {
-    TracePrintf(0, "parent pid: %d, child pid: %d\n", current_pcb->pid, pcb->pid);
-    if (pcb->parent->pid == current_pcb->pid)
-    {
-      pcb_remove(defunct_processes, pcb);
-      pcb_enqueue(ready_processes, pcb);
-      pcb->state = PCB_STATE_READY;
-      *status_ptr = pcb->exit_status;
-      int pid = pcb->pid;
-      DestroyPCB(pcb);
-      return pid;
-    }
+    pcb_enqueue(current_pcb->zombies, child);
+    return ERROR;
   }
-  return ERROR;
+  *status_ptr = child->exit_status;
+  int pid = child->pid;
+  RemoveChild(current_pcb, child);
+  DestroyPCB(child);
+  return pid;
 }
 
 int SysGetPid(void)
@@ -171,7 +305,7 @@ int SysBrk(void *addr)
 
     for (int i = brk_start_page; i < new_brk_page; i++)
     {
-      int frame = GetFrame();
+      int frame = GetUserFrame(pcb);
       if (frame == -1)
       {
         return ERROR;
@@ -197,12 +331,12 @@ int SysBrk(void *addr)
   {
     for (int i = brk_page; i < new_brk_page; i++)
     {
-      pcb->page_table[i].valid = 1;
-      int frame = GetFrame();
+      int frame = GetUserFrame(pcb);
       if (frame == -1)
       {
         return ERROR;
       }
+      pcb->page_table[i].valid = 1;
       TracePrintf(0, "Allocating frame %d for page %d\n", frame, i);
       pcb->page_table[i].pfn = frame;
       pcb->page_table[i].prot = PROT_READ | PROT_WRITE;
@@ -220,7 +354,7 @@ int SysBrk(void *addr)
 
       int frame = pcb->page_table[i].pfn;
       pcb->page_table[i].valid = 0;
-      FreeFrame(frame);
+      FreeUserFrame(pcb, frame);
       WriteRegister(REG_TLB_FLUSH, (i << PAGESHIFT) + VMEM_0_SIZE);
     }
   }
@@ -231,6 +365,12 @@ int SysBrk(void *addr)
   return 0;
 }
 
+// Timer callback for Delay: the sleep is over
+static void WakeDelayed(pcb_t *pcb)
+{
+  MakeReady(pcb, SCHED_WOKEN);
+}
+
 int SysDelay(int clock_ticks)
 {
   pcb_t *pcb = GetCurrentProcess();
@@ -248,19 +388,272 @@ int SysDelay(int clock_ticks)
     return 0;
   }
 
-  // Set the number of ticks the process needs to wait
-  pcb->delay_ticks = clock_ticks;
-
   // Set process state to BLOCKED
   pcb->state = PCB_STATE_BLOCKED;
 
-  // Add process to delay queue
-  pcb_enqueue(blocked_processes, pcb);
+  // The timer wheel wakes the process when its delay is up
+  StartTimer(pcb, clock_ticks, WakeDelayed);
 
   // call the next process (if there is one else idle) as current process is blocked
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+  pcb_t *next = PickNextProcess();
 
   int rc = KernelContextSwitch(KCSwitch, pcb, next);
 
   return 0;
-}
\ No newline at end of file
+}
+
+/*
+ * LookupManagedProcess - Resolves the process a kill, limit or priority call applies to.
+ * pid 0 means the caller; otherwise the target must be the caller or one of its children.
+ */
+static pcb_t *LookupManagedProcess(int pid)
+{
+  pcb_t *current_pcb = GetCurrentProcess();
+  if (pid == 0 || pid == current_pcb->pid)
+  {
+    return current_pcb;
+  }
+
+  pcb_t *target = FindPCB(pid);
+  if (target == NULL || target->parent != current_pcb)
+  {
+    return NULL;
+  }
+  return target;
+}
+
+int SysKill(int pid)
+{
+  pcb_t *current_pcb = GetCurrentProcess();
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL || target == idle_pcb || target->pid == 1 || target->state == PCB_STATE_DEFUNCT)
+  {
+    TracePrintf(0, "SysKill: Process %d cannot kill process %d\n", current_pcb->pid, pid);
+    return ERROR;
+  }
+
+  if (target == current_pcb)
+  {
+    SysExit(ERROR);
+  }
+
+  TracePrintf(0, "SysKill: Process %d killing process %d\n", current_pcb->pid, pid);
+
+  ReleaseProcessState(target);
+  target->waiting_for_child = 0;
+
+  target->exit_status = ERROR;
+  ReleaseChildren(target);
+  FreeProcessMemory(target);
+
+  // The target is not running, so without a parent it can be freed right away
+  if (target->parent != NULL)
+  {
+    HandToParent(target);
+  }
+  else
+  {
+    DestroyPCB(target);
+  }
+
+  return SUCCESS;
+}
+
+int SysSetLimit(int pid, int resource, int value)
+{
+  if (resource < 0 || resource >= NUM_LIMITS || value < 0)
+  {
+    return ERROR;
+  }
+
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    TracePrintf(0, "SysSetLimit: Process %d may not change limits of %d\n", GetCurrentProcess()->pid, pid);
+    return ERROR;
+  }
+
+  // A process can never hand out more than it is allowed itself
+  int own_limit = GetCurrentProcess()->limits[resource];
+  if (value > own_limit)
+  {
+    TracePrintf(0, "SysSetLimit: Limit %d cannot be raised above %d\n", resource, own_limit);
+    return ERROR;
+  }
+
+  target->limits[resource] = value;
+  return SUCCESS;
+}
+
+int SysGetLimit(int pid, int resource)
+{
+  if (resource < 0 || resource >= NUM_LIMITS)
+  {
+    return ERROR;
+  }
+
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    return ERROR;
+  }
+
+  return target->limits[resource];
+}
+
+int SysSetPriority(int pid, int priority)
+{
+  if (priority < 0 || priority >= PRIO_LEVELS)
+  {
+    return ERROR;
+  }
+
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    TracePrintf(0, "SysSetPriority: Process %d may not change the priority of %d\n", GetCurrentProcess()->pid, pid);
+    return ERROR;
+  }
+
+  // Like limits, a process cannot raise anyone above its own priority; inherited boosts do not count
+  if (priority < GetCurrentProcess()->base_priority)
+  {
+    TracePrintf(0, "SysSetPriority: Priority cannot be raised above %d\n", GetCurrentProcess()->base_priority);
+    return ERROR;
+  }
+
+  SetBasePriority(target, priority);
+  return SUCCESS;
+}
+
+int SysGetPriority(int pid)
+{
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    return ERROR;
+  }
+
+  return target->priority;
+}
+
+int SysGroupCreate(int tickets)
+{
+  // Only processes in the default group hand out shares; tenants cannot grow their own
+  if (GetCurrentProcess()->sched_group != 0)
+  {
+    TracePrintf(0, "SysGroupCreate: Process %d is not in the default group\n", GetCurrentProcess()->pid);
+    return ERROR;
+  }
+  return CreateSchedGroup(tickets);
+}
+
+int SysGroupDestroy(int group)
+{
+  if (GetCurrentProcess()->sched_group != 0)
+  {
+    TracePrintf(0, "SysGroupDestroy: Process %d is not in the default group\n", GetCurrentProcess()->pid);
+    return ERROR;
+  }
+  return DestroySchedGroup(group);
+}
+
+int SysGroupMove(int pid, int group)
+{
+  if (GetCurrentProcess()->sched_group != 0)
+  {
+    TracePrintf(0, "SysGroupMove: Process %d is not in the default group\n", GetCurrentProcess()->pid);
+    return ERROR;
+  }
+
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    return ERROR;
+  }
+  return SetSchedGroup(target, group);
+}
+
+int SysGroupTicks(int group)
+{
+  return GetSchedGroupTicks(group);
+}
+
+int SysSetRealTime(int pid, int period, int budget)
+{
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    return ERROR;
+  }
+  return SetRealTime(target, period, budget);
+}
+
+int SysWaitPeriod(void)
+{
+  pcb_t *pcb = GetCurrentProcess();
+  if (WaitNextPeriod(pcb) == ERROR)
+  {
+    return ERROR;
+  }
+
+  if (pcb->state == PCB_STATE_BLOCKED)
+  {
+    pcb_t *next = PickNextProcess();
+    int rc = KernelContextSwitch(KCSwitch, pcb, next);
+    if (rc == -1)
+    {
+      TracePrintf(0, "KernelContextSwitch failed when waiting for the next period\n");
+      Halt();
+    }
+  }
+  return SUCCESS;
+}
+
+int SysDeadlineMisses(int pid)
+{
+  pcb_t *target = LookupManagedProcess(pid);
+  if (target == NULL)
+  {
+    return ERROR;
+  }
+  return target->rt_misses;
+}
+
+int SysSetQuantum(int ticks)
+{
+  int old_quantum = GetQuantum();
+  if (ticks < 0)
+  {
+    return ERROR;
+  }
+  if (ticks > 0)
+  {
+    if (GetCurrentProcess()->pid != init_pid)
+    {
+      TracePrintf(0, "SysSetQuantum: Process %d is not init\n", GetCurrentProcess()->pid);
+      return ERROR;
+    }
+    SetQuantum(ticks);
+  }
+  return old_quantum;
+}
+
+int SysYield(void)
+{
+  YieldProcess(GetCurrentProcess());
+  return SUCCESS;
+}
+
+int SysSchedHint(int hint)
+{
+  if (hint < 0 || hint >= NUM_SCHED_HINTS)
+  {
+    return ERROR;
+  }
+
+  pcb_t *pcb = GetCurrentProcess();
+  int old_hint = pcb->sched_hint;
+  pcb->sched_hint = hint;
+  return old_hint;
+}
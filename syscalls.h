@@ -1,6 +1,55 @@
 #ifndef SYSCALLS_H
 #define SYSCALLS_H
 
+/*---------------------------------
+ * Kernel-specific system call codes
+ * (in addition to the ones in yalnix.h),
+ * passed as the first Custom0 argument
+ *--------------------------------*/
+#define YALNIX_EXT_BASE 0x100
+#define YALNIX_KILL (YALNIX_EXT_BASE + 0)
+#define YALNIX_SET_LIMIT (YALNIX_EXT_BASE + 1)
+#define YALNIX_GET_LIMIT (YALNIX_EXT_BASE + 2)
+#define YALNIX_FORKN (YALNIX_EXT_BASE + 3)
+#define YALNIX_MERGE_CTL (YALNIX_EXT_BASE + 4)
+#define YALNIX_SET_PRIORITY (YALNIX_EXT_BASE + 5)
+#define YALNIX_GET_PRIORITY (YALNIX_EXT_BASE + 6)
+#define YALNIX_GROUP_CREATE (YALNIX_EXT_BASE + 7)
+#define YALNIX_GROUP_MOVE (YALNIX_EXT_BASE + 8)
+#define YALNIX_GROUP_TICKS (YALNIX_EXT_BASE + 9)
+#define YALNIX_GROUP_DESTROY (YALNIX_EXT_BASE + 10)
+#define YALNIX_SET_REALTIME (YALNIX_EXT_BASE + 11)
+#define YALNIX_WAIT_PERIOD (YALNIX_EXT_BASE + 12)
+#define YALNIX_DEADLINE_MISSES (YALNIX_EXT_BASE + 13)
+#define YALNIX_SET_QUANTUM (YALNIX_EXT_BASE + 14)
+#define YALNIX_YIELD (YALNIX_EXT_BASE + 15)
+#define YALNIX_SCHED_HINT (YALNIX_EXT_BASE + 16)
+#define YALNIX_RWLOCK_INIT (YALNIX_EXT_BASE + 17)
+#define YALNIX_ACQUIRE_READ (YALNIX_EXT_BASE + 18)
+#define YALNIX_ACQUIRE_WRITE (YALNIX_EXT_BASE + 19)
+#define YALNIX_RELEASE_RW (YALNIX_EXT_BASE + 20)
+
+// yalnix.h may already reserve codes for semaphores; only fill in the missing ones
+#ifndef YALNIX_SEM_INIT
+#define YALNIX_SEM_INIT (YALNIX_EXT_BASE + 21)
+#endif
+#ifndef YALNIX_SEM_DOWN
+#define YALNIX_SEM_DOWN (YALNIX_EXT_BASE + 22)
+#endif
+#ifndef YALNIX_SEM_UP
+#define YALNIX_SEM_UP (YALNIX_EXT_BASE + 23)
+#endif
+
+#define YALNIX_BARRIER_INIT (YALNIX_EXT_BASE + 24)
+#define YALNIX_BARRIER_WAIT (YALNIX_EXT_BASE + 25)
+#define YALNIX_ACQUIRE_TIMED (YALNIX_EXT_BASE + 26)
+#define YALNIX_CVAR_WAIT_TIMED (YALNIX_EXT_BASE + 27)
+#define YALNIX_PIPE_READ_TIMED (YALNIX_EXT_BASE + 28) // Trapped as Custom1
+#define YALNIX_TTY_READ_TIMED (YALNIX_EXT_BASE + 29)  // Trapped as Custom2
+#define YALNIX_LOCK_PROFILE (YALNIX_EXT_BASE + 30)
+
+#define FORKN_MAX 64 // Most children a single ForkN can create
+
 /**
  * SysFork - Creates a new child process that is a copy of the current process
  *
@@ -15,6 +64,23 @@
  */
 int SysFork(UserContext *uctxt);
 
+/**
+ * SysForkN - Creates several child processes in a single kernel entry
+ *
+ * Equivalent to calling Fork n times, but the user context, page table and
+ * kernel stack are read once and copied into every child, and the TLB is
+ * flushed once. Either all n children are created or none are.
+ *
+ * @param uctxt - Pointer to the user context of the calling process
+ * @param n - Number of children to create, 1 to FORKN_MAX
+ * @param pids - Region 1 array of n ints that receives the children's PIDs
+ *
+ * @return In the parent: n,
+ *         In child i: i (0 to n-1),
+ *         ERROR if n is out of range, the child limit would be exceeded or memory is insufficient
+ */
+int SysForkN(UserContext *uctxt, int n, int *pids);
+
 /**
  * SysExec - Replaces current process with a new program
  *
@@ -87,4 +153,196 @@ int SysBrk(void *addr);
  */
 int SysDelay(int clock_ticks);
 
+/**
+ * SysKill - Terminates the calling process or one of its children
+ *
+ * Removes the target from whatever queue it is on (ready, delay, lock,
+ * condition variable, pipe or terminal), cancels its pending pipe or
+ * terminal write, hands every lock it holds to the next waiter and frees
+ * its memory. The target then becomes a zombie with exit status ERROR
+ * for its parent to reap, or is freed at once if it has no parent.
+ *
+ * @param pid - PID of the process to terminate, 0 for the caller
+ *
+ * @return SUCCESS if the process was killed,
+ *         ERROR if the process is not the caller or one of its children, it has
+ *         already exited, or it is init or idle.
+ *         Does not return if the caller kills itself.
+ */
+int SysKill(int pid);
+
+/**
+ * SysSetLimit - Sets a resource limit of the calling process or one of its children
+ *
+ * Limits are inherited on fork. A process cannot set any limit above its own.
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ * @param resource - Which limit to set (see resource_limit_t in process.h)
+ * @param value - The new limit, or LIMIT_UNLIMITED
+ *
+ * @return SUCCESS on success,
+ *         ERROR if the resource is invalid, the value is negative, the target is not the caller or
+ *         one of its children, or the value exceeds the caller's own limit
+ */
+int SysSetLimit(int pid, int resource, int value);
+
+/**
+ * SysGetLimit - Returns a resource limit of the calling process or one of its children
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ * @param resource - Which limit to query (see resource_limit_t in process.h)
+ *
+ * @return The limit (LIMIT_UNLIMITED if none),
+ *         ERROR if the resource is invalid or the target is not the caller or one of its children
+ */
+int SysGetLimit(int pid, int resource);
+
+/**
+ * SysSetPriority - Sets the fixed priority of the calling process or one of its children
+ *
+ * Priorities are inherited on fork and used by the prio scheduler. A process
+ * cannot give any process a higher priority (lower number) than its own.
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ * @param priority - New priority, 0 (highest) to PRIO_LEVELS - 1
+ *
+ * @return SUCCESS on success,
+ *         ERROR if the priority is out of range or above the caller's, or the target is not
+ *         the caller or one of its children
+ */
+int SysSetPriority(int pid, int priority);
+
+/**
+ * SysGetPriority - Returns the fixed priority of the calling process or one of its children
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ *
+ * @return The priority,
+ *         ERROR if the target is not the caller or one of its children
+ */
+int SysGetPriority(int pid);
+
+/**
+ * SysGroupCreate - Creates a scheduling group with a share of the CPU
+ *
+ * Under the stride scheduler each group gets CPU time in proportion to its
+ * tickets, however many processes it holds. Only processes in the default
+ * group 0 may create groups.
+ *
+ * @param tickets - The group's share, 1 to STRIDE_MAX_TICKETS
+ *
+ * @return The new group's ID,
+ *         ERROR if the caller is not in group 0, the ticket count is invalid or no group is free
+ */
+int SysGroupCreate(int tickets);
+
+/**
+ * SysGroupDestroy - Destroys an empty scheduling group
+ *
+ * Frees the group's ID for a later GroupCreate. Only processes in the
+ * default group 0 may destroy groups.
+ *
+ * @param group - ID of the group, never 0
+ *
+ * @return SUCCESS on success,
+ *         ERROR if the caller is not in group 0, the group does not exist or a live process is still in it
+ */
+int SysGroupDestroy(int group);
+
+/**
+ * SysGroupMove - Moves the calling process or one of its children to another group
+ *
+ * Only processes in the default group 0 may move processes, so a process
+ * placed in a tenant group cannot leave it. Children inherit the group on fork.
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ * @param group - ID of the destination group
+ *
+ * @return SUCCESS on success,
+ *         ERROR if the caller is not in group 0, the target is not the caller or one of its
+ *         children, or the group does not exist
+ */
+int SysGroupMove(int pid, int group);
+
+/**
+ * SysGroupTicks - Returns the clock ticks consumed by a scheduling group
+ *
+ * @param group - ID of the group
+ *
+ * @return Ticks consumed by the group's processes, ERROR if the group does not exist
+ */
+int SysGroupTicks(int group);
+
+/**
+ * SysSetRealTime - Reserves a periodic CPU budget for the calling process or one of its children
+ *
+ * Real-time processes run by earliest deadline ahead of all normal processes.
+ * The reservation is refused if total real-time utilization would exceed RT_UTIL_MAX / RT_UTIL_SCALE.
+ * It is not inherited on fork.
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ * @param period - Period in clock ticks, 0 to return to normal scheduling
+ * @param budget - Ticks of CPU per period, 1 to period
+ *
+ * @return SUCCESS on success,
+ *         ERROR if the values are invalid, admission fails, or the target is not the caller or
+ *         one of its children
+ */
+int SysSetRealTime(int pid, int period, int budget);
+
+/**
+ * SysWaitPeriod - Ends the current period's work and sleeps until the next period
+ *
+ * Replaces the Delay loop of a periodic task. If the deadline has already
+ * passed the miss is counted and the call returns at once.
+ *
+ * @return SUCCESS on success, ERROR if the caller is not real-time
+ */
+int SysWaitPeriod(void);
+
+/**
+ * SysDeadlineMisses - Returns how many deadlines a real-time process has missed
+ *
+ * @param pid - PID of the target process, 0 for the caller
+ *
+ * @return Number of missed deadlines,
+ *         ERROR if the target is not the caller or one of its children
+ */
+int SysDeadlineMisses(int pid);
+
+/**
+ * SysSetQuantum - Sets or reads the scheduler's base time quantum
+ *
+ * The quantum is shared by every group, so only init may change it.
+ *
+ * @param ticks - New quantum in clock ticks, or 0 to leave it unchanged
+ *
+ * @return The quantum in effect before the call,
+ *         ERROR if ticks is negative or the caller may not change it
+ */
+int SysSetQuantum(int ticks);
+
+/**
+ * SysYield - Gives up the CPU to any other ready process
+ *
+ * The caller goes behind the other ready processes of its policy. If nothing
+ * else is ready it returns at once, unlike Delay(1), which always sleeps a tick.
+ *
+ * @return SUCCESS
+ */
+int SysYield(void);
+
+/**
+ * SysSchedHint - Declares the calling process batch, interactive or normal
+ *
+ * Batch processes get doubled slices, sit at the bottom MLFQ level and get
+ * no CFS wake-up credit. Interactive processes never sink below the middle
+ * MLFQ level. The hint is inherited on fork.
+ *
+ * @param hint - One of sched_hint_t (see scheduler.h)
+ *
+ * @return The previous hint, ERROR if the hint is invalid
+ */
+int SysSchedHint(int hint);
+
 #endif // SYSCALLS_H
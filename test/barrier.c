@@ -0,0 +1,90 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_PARTIES 4 // Init and three children
+#define NUM_PHASES 5
+
+int main(void)
+{
+  int barrier;
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, barrier!\n");
+
+  if (BarrierInit(&barrier, 0) != -1)
+  {
+    TracePrintf(0, "Barrier with no parties accepted\n");
+    Exit(1);
+  }
+
+  // A single party never blocks and is always the serial one
+  BarrierInit(&barrier, 1);
+  if (BarrierWait(barrier) != BARRIER_SERIAL || BarrierWait(barrier) != BARRIER_SERIAL)
+  {
+    TracePrintf(0, "A one-party barrier did not return BARRIER_SERIAL\n");
+    Exit(1);
+  }
+  Reclaim(barrier);
+
+  // Each phase every child reports its phase then waits; nobody may report the
+  // next phase before all reports of this one are in. Each party exits with
+  // how often it was the serial process, which must add up to once per phase.
+  BarrierInit(&barrier, NUM_PARTIES);
+  PipeInit(&pipe);
+  for (int i = 1; i < NUM_PARTIES; i++)
+  {
+    if (Fork() == 0)
+    {
+      int serials = 0;
+      for (int phase = 0; phase < NUM_PHASES; phase++)
+      {
+        Delay(i);
+        PipeWrite(pipe, &phase, sizeof(phase));
+        if (BarrierWait(barrier) == BARRIER_SERIAL)
+        {
+          serials++;
+        }
+      }
+      Exit(serials);
+    }
+  }
+
+  // Init takes part too, arriving last in even phases and first in odd ones
+  int serials = 0;
+  for (int phase = 0; phase < NUM_PHASES; phase++)
+  {
+    if (phase % 2 == 1 && BarrierWait(barrier) == BARRIER_SERIAL)
+    {
+      serials++;
+    }
+    for (int i = 1; i < NUM_PARTIES; i++)
+    {
+      int report;
+      PipeRead(pipe, &report, sizeof(report));
+      if (report != phase)
+      {
+        TracePrintf(0, "Got a phase %d report during phase %d\n", report, phase);
+        Exit(1);
+      }
+    }
+    if (phase % 2 == 0 && BarrierWait(barrier) == BARRIER_SERIAL)
+    {
+      serials++;
+    }
+  }
+  for (int i = 1; i < NUM_PARTIES; i++)
+  {
+    Wait(&status);
+    serials += status;
+  }
+  if (serials != NUM_PHASES)
+  {
+    TracePrintf(0, "%d serial processes over %d phases\n", serials, NUM_PHASES);
+    Exit(1);
+  }
+
+  Reclaim(barrier);
+  TracePrintf(0, "Barrier tests passed\n");
+  Exit(0);
+}
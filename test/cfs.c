@@ -0,0 +1,78 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Boot with sched=cfs. Two hogs report each chunk of work through a pipe;
+// the order of their reports shows how the CPU was shared.
+
+#define NUM_CHUNKS 40
+#define CHUNK_LOOPS 2000000
+
+static void Hog(int pipe, char tag, int priority)
+{
+  SetPriority(0, priority);
+  for (int chunk = 0; chunk < NUM_CHUNKS; chunk++)
+  {
+    for (volatile int i = 0; i < CHUNK_LOOPS; i++)
+    {
+    }
+    PipeWrite(pipe, &tag, 1);
+  }
+  Exit(0);
+}
+
+// Runs two hogs and returns how many of the first NUM_CHUNKS reports came from the first
+static int Race(int pipe, int first_priority, int second_priority)
+{
+  int status;
+  char tag;
+  int first_count = 0;
+
+  if (Fork() == 0)
+  {
+    Hog(pipe, 'a', first_priority);
+  }
+  if (Fork() == 0)
+  {
+    Hog(pipe, 'b', second_priority);
+  }
+  for (int i = 0; i < 2 * NUM_CHUNKS; i++)
+  {
+    PipeRead(pipe, &tag, 1);
+    if (i < NUM_CHUNKS && tag == 'a')
+    {
+      first_count++;
+    }
+  }
+  Wait(&status);
+  Wait(&status);
+  return first_count;
+}
+
+int main(void)
+{
+  int pipe;
+
+  TracePrintf(0, "Hello, cfs!\n");
+  PipeInit(&pipe);
+
+  // Equal weights share evenly
+  int even = Race(pipe, PRIO_DEFAULT, PRIO_DEFAULT);
+  TracePrintf(0, "Equal hogs: %d of the first %d chunks from the first\n", even, NUM_CHUNKS);
+  if (even < NUM_CHUNKS / 3 || even > NUM_CHUNKS - NUM_CHUNKS / 3)
+  {
+    TracePrintf(0, "Equal weight hogs did not share the CPU\n");
+    Exit(1);
+  }
+
+  // Four levels down weighs about 0.4, so the heavier hog gets well over half, but not all
+  int weighted = Race(pipe, PRIO_DEFAULT, PRIO_DEFAULT + 4);
+  TracePrintf(0, "Weighted hogs: %d of the first %d chunks from the heavier\n", weighted, NUM_CHUNKS);
+  if (weighted < NUM_CHUNKS * 3 / 5 || weighted == NUM_CHUNKS)
+  {
+    TracePrintf(0, "Weights were not honoured\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "CFS tests passed\n");
+  Exit(0);
+}
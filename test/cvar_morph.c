@@ -0,0 +1,71 @@
+#include <yuser.h>
+
+#define NUM_WAITERS 5
+
+int main(void)
+{
+  int lock;
+  int cvar;
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, cvar morph!\n");
+  LockInit(&lock);
+  CvarInit(&cvar);
+  PipeInit(&pipe);
+
+  for (int i = 0; i < NUM_WAITERS; i++)
+  {
+    if (Fork() == 0)
+    {
+      Acquire(lock);
+      PipeWrite(pipe, "R", 1);
+      CvarWait(cvar, lock);
+
+      // Back in the lock after the broadcast: nobody else may get in meanwhile
+      PipeWrite(pipe, "S", 1);
+      Delay(1);
+      PipeWrite(pipe, "E", 1);
+      Release(lock);
+      Exit(0);
+    }
+  }
+
+  // Each child reports ready while holding the lock, so once we hold it they are all waiting
+  char tag;
+  for (int i = 0; i < NUM_WAITERS; i++)
+  {
+    PipeRead(pipe, &tag, 1);
+  }
+  Acquire(lock);
+  CvarBroadcast(cvar);
+  Release(lock);
+
+  for (int i = 0; i < 2 * NUM_WAITERS; i++)
+  {
+    PipeRead(pipe, &tag, 1);
+    if (tag != ((i % 2 == 0) ? 'S' : 'E'))
+    {
+      TracePrintf(0, "Report %d was %c: two waiters held the lock at once\n", i, tag);
+      Exit(1);
+    }
+  }
+  for (int i = 0; i < NUM_WAITERS; i++)
+  {
+    if (Wait(&status) < 0 || status != 0)
+    {
+      TracePrintf(0, "A waiter failed\n");
+      Exit(1);
+    }
+  }
+
+  // A broadcast with nobody waiting is harmless
+  if (CvarBroadcast(cvar) != 0 || CvarSignal(cvar) != 0)
+  {
+    TracePrintf(0, "Broadcast on an empty cvar failed\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Cvar morph tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,54 @@
+#include <yuser.h>
+
+// Delays that share a timer wheel slot (3, 67, 131) or wrap past it must
+// still expire in order of their length. Close lengths are forked shortest
+// first so the time taken by Fork cannot reorder them.
+static int delays[] = {131, 3, 20, 64, 1, 65, 67};
+
+#define NUM_SLEEPERS (int)(sizeof(delays) / sizeof(delays[0]))
+
+int main(void)
+{
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, delay!\n");
+
+  if (Delay(-1) != -1 || Delay(0) != 0)
+  {
+    TracePrintf(0, "Delay accepted a negative count or blocked for zero ticks\n");
+    Exit(1);
+  }
+
+  PipeInit(&pipe);
+  for (int i = 0; i < NUM_SLEEPERS; i++)
+  {
+    if (Fork() == 0)
+    {
+      Delay(delays[i]);
+      PipeWrite(pipe, &delays[i], sizeof(int));
+      Exit(0);
+    }
+  }
+
+  int last = 0;
+  for (int i = 0; i < NUM_SLEEPERS; i++)
+  {
+    int woke;
+    PipeRead(pipe, &woke, sizeof(woke));
+    TracePrintf(0, "Sleeper for %d ticks woke\n", woke);
+    if (woke < last)
+    {
+      TracePrintf(0, "Sleeper for %d ticks woke after one for %d\n", woke, last);
+      Exit(1);
+    }
+    last = woke;
+  }
+  for (int i = 0; i < NUM_SLEEPERS; i++)
+  {
+    Wait(&status);
+  }
+
+  TracePrintf(0, "Delay tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,72 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_CHILDREN 8
+
+int main(void)
+{
+  int pids[NUM_CHILDREN];
+  int status;
+  int counter = 100;
+
+  TracePrintf(0, "Hello, forkn!\n");
+
+  if (ForkN(0, pids) != -1 || ForkN(FORKN_MAX + 1, pids) != -1)
+  {
+    TracePrintf(0, "ForkN accepted an out-of-range count\n");
+    Exit(1);
+  }
+
+  int rc = ForkN(NUM_CHILDREN, pids);
+  if (rc < 0)
+  {
+    TracePrintf(0, "ForkN failed with %d\n", rc);
+    Exit(1);
+  }
+  if (rc < NUM_CHILDREN)
+  {
+    // Child rc: each child has its own copy of the parent's memory
+    counter += rc;
+    Exit(counter);
+  }
+
+  // Every child is reaped exactly once, with the status that matches its index
+  int seen[NUM_CHILDREN] = {0};
+  for (int i = 0; i < NUM_CHILDREN; i++)
+  {
+    int pid = Wait(&status);
+    int index = status - 100;
+    if (index < 0 || index >= NUM_CHILDREN || pids[index] != pid || seen[index])
+    {
+      TracePrintf(0, "Unexpected child %d with status %d\n", pid, status);
+      Exit(1);
+    }
+    seen[index] = 1;
+  }
+  if (counter != 100)
+  {
+    TracePrintf(0, "A child's write reached the parent\n");
+    Exit(1);
+  }
+
+  // All or nothing: with room for only 2 more children, asking for 3 creates none
+  int pid = Fork();
+  if (pid == 0)
+  {
+    SetLimit(0, LIMIT_CHILDREN, 2);
+    int more[3];
+    if (ForkN(3, more) != -1 || Wait(&status) != -1)
+    {
+      Exit(1);
+    }
+    Exit(0);
+  }
+  if (Wait(&status) != pid || status != 0)
+  {
+    TracePrintf(0, "A failed ForkN created children\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "ForkN tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,108 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Boot with sched=stride for the share check; the other checks hold under any policy.
+
+static int StartHog(int group)
+{
+  int pid = Fork();
+  if (pid == 0)
+  {
+    for (;;)
+    {
+    }
+  }
+  GroupMove(pid, group);
+  return pid;
+}
+
+int main(void)
+{
+  int hogs[3];
+  int status;
+
+  TracePrintf(0, "Hello, groups!\n");
+
+  if (GroupCreate(0) != -1 || GroupCreate(STRIDE_MAX_TICKETS + 1) != -1)
+  {
+    TracePrintf(0, "Invalid ticket count accepted\n");
+    Exit(1);
+  }
+  if (GroupTicks(0) < 0 || GroupTicks(MAX_SCHED_GROUPS) != -1)
+  {
+    TracePrintf(0, "GroupTicks did not check the group\n");
+    Exit(1);
+  }
+
+  int big = GroupCreate(300);
+  int small = GroupCreate(100);
+  if (big <= 0 || small <= 0 || big == small)
+  {
+    TracePrintf(0, "GroupCreate returned %d and %d\n", big, small);
+    Exit(1);
+  }
+
+  // A process in a tenant group cannot create groups or leave its own
+  int tenant = Fork();
+  if (tenant == 0)
+  {
+    Delay(2);
+    Exit((GroupCreate(10) == -1 && GroupMove(0, 0) == -1 && GroupDestroy(small) == -1) ? 0 : 2);
+  }
+  if (GroupMove(tenant, small) != 0 || Wait(&status) != tenant || status != 0)
+  {
+    TracePrintf(0, "Tenant child %d escaped its group\n", tenant);
+    Exit(1);
+  }
+
+  // One hog with 300 tickets against two sharing 100 should get about three times the CPU
+  hogs[0] = StartHog(big);
+  hogs[1] = StartHog(small);
+  hogs[2] = StartHog(small);
+  Delay(10);
+  int big_start = GroupTicks(big);
+  int small_start = GroupTicks(small);
+  Delay(200);
+  int big_ticks = GroupTicks(big) - big_start;
+  int small_ticks = GroupTicks(small) - small_start;
+  TracePrintf(0, "Group %d used %d ticks, group %d used %d\n", big, big_ticks, small, small_ticks);
+  if (small_ticks <= 0 || big_ticks < 2 * small_ticks || big_ticks > 4 * small_ticks)
+  {
+    TracePrintf(0, "Groups did not share the CPU 3:1\n");
+    Exit(1);
+  }
+
+  // Groups with live members cannot be destroyed
+  if (GroupDestroy(0) != -1 || GroupDestroy(big) != -1)
+  {
+    TracePrintf(0, "Destroyed a group that is still in use\n");
+    Exit(1);
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    Kill(hogs[i]);
+    Wait(&status);
+  }
+  if (GroupDestroy(big) != 0 || GroupDestroy(small) != 0 || GroupDestroy(big) != -1)
+  {
+    TracePrintf(0, "Could not destroy the emptied groups exactly once\n");
+    Exit(1);
+  }
+  if (GroupTicks(big) != -1)
+  {
+    TracePrintf(0, "A destroyed group still reports ticks\n");
+    Exit(1);
+  }
+
+  // Destroyed IDs are handed out again
+  int reused = GroupCreate(50);
+  if (reused != big && reused != small)
+  {
+    TracePrintf(0, "GroupCreate returned %d, expected a freed ID\n", reused);
+    Exit(1);
+  }
+  GroupDestroy(reused);
+
+  TracePrintf(0, "Group tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,72 @@
+#include <yuser.h>
+
+// Boot with handoff=1 so blocking wake-ups switch straight to the woken process.
+
+#define NUM_ROUNDS 100
+
+int main(void)
+{
+  int ping;
+  int pong;
+  int lock;
+  int cvar;
+  int status;
+
+  TracePrintf(0, "Hello, handoff!\n");
+
+  // Ping-pong: each write wakes the process blocked reading the other end
+  PipeInit(&ping);
+  PipeInit(&pong);
+  int child = Fork();
+  if (child == 0)
+  {
+    int value;
+    for (int i = 0; i < NUM_ROUNDS; i++)
+    {
+      PipeRead(ping, &value, sizeof(value));
+      value++;
+      PipeWrite(pong, &value, sizeof(value));
+    }
+    Exit(0);
+  }
+  int value = 0;
+  for (int i = 0; i < NUM_ROUNDS; i++)
+  {
+    PipeWrite(ping, &value, sizeof(value));
+    PipeRead(pong, &value, sizeof(value));
+    if (value != i + 1)
+    {
+      TracePrintf(0, "Round %d came back as %d\n", i, value);
+      Exit(1);
+    }
+  }
+  Wait(&status);
+
+  // Waiting hands the lock to a queued child, which signals at once. The
+  // waiter must already be on the cvar, or the signal is lost and it hangs.
+  LockInit(&lock);
+  CvarInit(&cvar);
+  for (int i = 0; i < NUM_ROUNDS / 10; i++)
+  {
+    Acquire(lock);
+    int signaller = Fork();
+    if (signaller == 0)
+    {
+      Acquire(lock);
+      CvarSignal(cvar);
+      Release(lock);
+      Exit(0);
+    }
+    Delay(2);
+    CvarWait(cvar, lock);
+    Release(lock);
+    if (Wait(&status) != signaller || status != 0)
+    {
+      TracePrintf(0, "Signaller %d failed\n", signaller);
+      Exit(1);
+    }
+  }
+
+  TracePrintf(0, "Handoff tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,132 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Kills a child and checks that Wait reports it with status ERROR
+static void KillAndReap(int pid, char *what)
+{
+  int status;
+  if (Kill(pid) != 0)
+  {
+    TracePrintf(0, "Kill of the %s child %d failed\n", what, pid);
+    Exit(1);
+  }
+  int reaped = Wait(&status);
+  if (reaped != pid || status != -1)
+  {
+    TracePrintf(0, "Wait returned pid %d status %d for the %s child %d\n", reaped, status, what, pid);
+    Exit(1);
+  }
+  TracePrintf(0, "Killed and reaped the %s child %d\n", what, pid);
+}
+
+int main(void)
+{
+  int lock;
+  int pipe;
+  char byte = 'x';
+
+  TracePrintf(0, "Hello, kill!\n");
+  LockInit(&lock);
+  PipeInit(&pipe);
+
+  // A child asleep in Delay sits in the timer wheel
+  int sleeper = Fork();
+  if (sleeper == 0)
+  {
+    Delay(1000);
+    Exit(0);
+  }
+  Delay(2);
+  KillAndReap(sleeper, "delayed");
+
+  // A child queued on a lock; the lock must still work for the next waiter
+  Acquire(lock);
+  int waiter = Fork();
+  if (waiter == 0)
+  {
+    Acquire(lock);
+    Exit(0);
+  }
+  Delay(2);
+  KillAndReap(waiter, "lock waiting");
+  Release(lock);
+  if (Acquire(lock) != 0 || Release(lock) != 0)
+  {
+    TracePrintf(0, "Lock unusable after its waiter was killed\n");
+    Exit(1);
+  }
+
+  // A child blocked reading an empty pipe must not swallow the next write
+  int reader = Fork();
+  if (reader == 0)
+  {
+    PipeRead(pipe, &byte, 1);
+    Exit(0);
+  }
+  Delay(2);
+  KillAndReap(reader, "pipe reading");
+  char got = 0;
+  PipeWrite(pipe, &byte, 1);
+  if (PipeRead(pipe, &got, 1) != 1 || got != byte)
+  {
+    TracePrintf(0, "Pipe lost data to a killed reader\n");
+    Exit(1);
+  }
+
+  // Only the caller and its own children may be killed
+  int middle = Fork();
+  if (middle == 0)
+  {
+    int grandchild = Fork();
+    if (grandchild == 0)
+    {
+      Delay(1000);
+      Exit(0);
+    }
+    PipeWrite(pipe, &grandchild, sizeof(grandchild));
+    Delay(5);
+    if (Kill(1) != -1)
+    {
+      TracePrintf(0, "A child was allowed to kill init\n");
+      Exit(1);
+    }
+    int status;
+    Exit((Kill(grandchild) == 0 && Wait(&status) == grandchild) ? 0 : 1);
+  }
+  int grandchild;
+  PipeRead(pipe, &grandchild, sizeof(grandchild));
+  if (Kill(grandchild) != -1)
+  {
+    TracePrintf(0, "Killed grandchild %d that is not our child\n", grandchild);
+    Exit(1);
+  }
+  int status;
+  if (Wait(&status) != middle || status != 0)
+  {
+    TracePrintf(0, "Child %d could not kill its own child\n", middle);
+    Exit(1);
+  }
+
+  // Kill(0) kills the caller
+  int suicide = Fork();
+  if (suicide == 0)
+  {
+    Kill(0);
+    Exit(0);
+  }
+  if (Wait(&status) != suicide || status != -1)
+  {
+    TracePrintf(0, "Kill(0) did not terminate child %d with ERROR\n", suicide);
+    Exit(1);
+  }
+
+  // Init itself cannot be killed
+  if (GetPid() == 1 && Kill(1) != -1)
+  {
+    TracePrintf(0, "Init was allowed to kill itself\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Kill tests passed\n");
+  Exit(0);
+}
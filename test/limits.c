@@ -0,0 +1,143 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Runs a test in a child, since limits can only be lowered, and checks its exit status
+static void RunChild(void (*test)(void), int expected_status, char *what)
+{
+  int status;
+  int pid = Fork();
+  if (pid == 0)
+  {
+    test();
+    Exit(0);
+  }
+  if (Wait(&status) != pid || status != expected_status)
+  {
+    TracePrintf(0, "%s: child %d exited with %d, expected %d\n", what, pid, status, expected_status);
+    Exit(1);
+  }
+  TracePrintf(0, "%s passed\n", what);
+}
+
+static void TestSyncObjects(void)
+{
+  int ids[3];
+  SetLimit(0, LIMIT_SYNC_OBJECTS, 2);
+  if (LockInit(&ids[0]) != 0 || CvarInit(&ids[1]) != 0)
+  {
+    Exit(2);
+  }
+  if (PipeInit(&ids[2]) != -1)
+  {
+    Exit(3);
+  }
+
+  // Reclaiming an object gives its place back
+  Reclaim(ids[0]);
+  if (PipeInit(&ids[2]) != 0)
+  {
+    Exit(4);
+  }
+
+  // A limit can be lowered but never raised again
+  if (SetLimit(0, LIMIT_SYNC_OBJECTS, 3) != -1 || GetLimit(0, LIMIT_SYNC_OBJECTS) != 2)
+  {
+    Exit(5);
+  }
+}
+
+static void TestChildren(void)
+{
+  int status;
+  SetLimit(0, LIMIT_CHILDREN, 2);
+  for (int i = 0; i < 2; i++)
+  {
+    if (Fork() == 0)
+    {
+      Exit(0);
+    }
+  }
+
+  // Exited but unreaped children still count
+  Delay(2);
+  if (Fork() != -1)
+  {
+    Exit(2);
+  }
+  Wait(&status);
+  int pid = Fork();
+  if (pid == 0)
+  {
+    Exit(0);
+  }
+  if (pid < 0)
+  {
+    Exit(3);
+  }
+  Wait(&status);
+  Wait(&status);
+}
+
+static void TestCpuTicks(void)
+{
+  // The kernel terminates the process with ERROR once it has used its ticks
+  SetLimit(0, LIMIT_CPU_TICKS, 20);
+  for (;;)
+  {
+  }
+}
+
+static void TestFrames(void)
+{
+  // Already over this limit, so the heap cannot grow
+  SetLimit(0, LIMIT_FRAMES, 1);
+  if (malloc(8 * 8192) != NULL)
+  {
+    Exit(2);
+  }
+}
+
+static void TestInherited(void)
+{
+  int status;
+  SetLimit(0, LIMIT_SYNC_OBJECTS, 5);
+  int pid = Fork();
+  if (pid == 0)
+  {
+    Exit(GetLimit(0, LIMIT_SYNC_OBJECTS));
+  }
+  if (Wait(&status) != pid || status != 5)
+  {
+    Exit(2);
+  }
+}
+
+int main(void)
+{
+  TracePrintf(0, "Hello, limits!\n");
+
+  if (GetLimit(0, LIMIT_CHILDREN) != LIMIT_UNLIMITED)
+  {
+    TracePrintf(0, "Init should start without limits\n");
+    Exit(1);
+  }
+  if (GetLimit(0, 99) != -1 || SetLimit(0, LIMIT_FRAMES, -5) != -1)
+  {
+    TracePrintf(0, "Invalid resource or value accepted\n");
+    Exit(1);
+  }
+  if (SetLimit(GetPid() + 1000, LIMIT_FRAMES, 10) != -1)
+  {
+    TracePrintf(0, "Set a limit on a process that is not our child\n");
+    Exit(1);
+  }
+
+  RunChild(TestSyncObjects, 0, "Sync object limit");
+  RunChild(TestChildren, 0, "Child limit");
+  RunChild(TestCpuTicks, -1, "CPU tick limit");
+  RunChild(TestFrames, 0, "Frame limit");
+  RunChild(TestInherited, 0, "Inherited limits");
+
+  TracePrintf(0, "Limit tests passed\n");
+  Exit(0);
+}
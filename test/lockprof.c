@@ -0,0 +1,113 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_WAITERS 3
+#define NUM_QUIET 3
+
+static lock_profile_t stats[LOCK_PROFILE_MAX];
+
+// Returns the profile of a lock from the last report, or NULL if it is missing
+static lock_profile_t *FindProfile(int lock, int found)
+{
+  for (int i = 0; i < found; i++)
+  {
+    if (stats[i].id == lock)
+    {
+      return &stats[i];
+    }
+  }
+  return NULL;
+}
+
+int main(void)
+{
+  int hot;
+  int quiet;
+  int status;
+
+  TracePrintf(0, "Hello, lock profile!\n");
+
+  if (LockProfile(1, stats, -1) != -1)
+  {
+    TracePrintf(0, "Negative count accepted\n");
+    Exit(1);
+  }
+  if (LockProfile(1, NULL, 0) != 0)
+  {
+    TracePrintf(0, "Could not turn profiling on\n");
+    Exit(1);
+  }
+  LockInit(&hot);
+  LockInit(&quiet);
+
+  for (int i = 0; i < NUM_QUIET; i++)
+  {
+    Acquire(quiet);
+    Release(quiet);
+  }
+
+  // Every child queues behind us on the hot lock
+  Acquire(hot);
+  for (int i = 0; i < NUM_WAITERS; i++)
+  {
+    if (Fork() == 0)
+    {
+      Acquire(hot);
+      Release(hot);
+      Exit(0);
+    }
+  }
+  Delay(5);
+  Release(hot);
+  for (int i = 0; i < NUM_WAITERS; i++)
+  {
+    Wait(&status);
+  }
+
+  int found = LockProfile(-1, stats, LOCK_PROFILE_MAX);
+  lock_profile_t *hot_profile = FindProfile(hot, found);
+  lock_profile_t *quiet_profile = FindProfile(quiet, found);
+  if (found < 2 || hot_profile != &stats[0] || quiet_profile == NULL)
+  {
+    TracePrintf(0, "Got %d profiles; the hot lock should come first\n", found);
+    Exit(1);
+  }
+  TracePrintf(0, "Hot lock: %d acquisitions, %d contended, %d wait ticks, queue depth %d\n",
+              hot_profile->acquisitions, hot_profile->contended, hot_profile->wait_ticks,
+              hot_profile->max_queue_depth);
+  if (hot_profile->acquisitions != NUM_WAITERS + 1 || hot_profile->contended != NUM_WAITERS ||
+      hot_profile->max_queue_depth != NUM_WAITERS || hot_profile->wait_ticks <= 0 ||
+      hot_profile->max_wait_ticks <= 0 || hot_profile->hold_ticks <= 0)
+  {
+    TracePrintf(0, "Hot lock counters are wrong\n");
+    Exit(1);
+  }
+  if (quiet_profile->acquisitions != NUM_QUIET || quiet_profile->contended != 0)
+  {
+    TracePrintf(0, "Quiet lock has %d acquisitions and %d contended\n",
+                quiet_profile->acquisitions, quiet_profile->contended);
+    Exit(1);
+  }
+
+  // A short array gets only the most contended locks
+  if (LockProfile(-1, stats, 1) != 1 || stats[0].id != hot)
+  {
+    TracePrintf(0, "A one-entry report did not hold the hot lock\n");
+    Exit(1);
+  }
+
+  // Nothing is counted while profiling is off
+  LockProfile(0, NULL, 0);
+  Acquire(quiet);
+  Release(quiet);
+  found = LockProfile(-1, stats, LOCK_PROFILE_MAX);
+  quiet_profile = FindProfile(quiet, found);
+  if (quiet_profile == NULL || quiet_profile->acquisitions != NUM_QUIET)
+  {
+    TracePrintf(0, "An acquisition was counted with profiling off\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Lock profile tests passed\n");
+  Exit(0);
+}
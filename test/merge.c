@@ -0,0 +1,107 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_CHILDREN 3
+#define NUM_PAGES 8
+#define PAGE_BYTES 8192
+
+// Page aligned so each child's copy of a page hashes the same
+static char pages[NUM_PAGES][PAGE_BYTES] __attribute__((aligned(PAGE_BYTES)));
+
+// Lets the idle process run long enough to scan every page a few times
+static void WaitForMerger(void)
+{
+  Delay(50);
+}
+
+static void RunChild(int slot)
+{
+  merge_stats_t stats;
+  WaitForMerger();
+
+  // A write after the merge must stay private to this child
+  pages[0][0] = 'a' + slot;
+  WaitForMerger();
+  if (pages[0][0] != 'a' + slot || pages[1][0] != 'p')
+  {
+    TracePrintf(0, "Child %d sees page contents %c %c\n", slot, pages[0][0], pages[1][0]);
+    Exit(2);
+  }
+
+  // The kernel storing a new ID onto a merged page must split it first
+  if (LockInit((int *)pages[2 + slot]) != 0 || CvarInit((int *)pages[5]) != 0)
+  {
+    Exit(3);
+  }
+  if (MergeControl(-1, &stats) != 0)
+  {
+    Exit(4);
+  }
+  Exit(0);
+}
+
+int main(void)
+{
+  merge_stats_t before;
+  merge_stats_t after;
+  int status;
+
+  TracePrintf(0, "Hello, merge!\n");
+
+  if (MergeControl(16, &before) != 0 || before.scan_rate != 16)
+  {
+    TracePrintf(0, "MergeControl could not set the scan rate\n");
+    Exit(1);
+  }
+
+  for (int i = 0; i < NUM_PAGES; i++)
+  {
+    memset(pages[i], 'p', PAGE_BYTES);
+  }
+  for (int i = 0; i < NUM_CHILDREN; i++)
+  {
+    if (Fork() == 0)
+    {
+      RunChild(i);
+    }
+  }
+
+  WaitForMerger();
+  MergeControl(-1, &after);
+  TracePrintf(0, "Scanned %d pages, %d merges, %d pages merged\n",
+              after.pages_scanned - before.pages_scanned, after.merges - before.merges, after.pages_merged);
+  if (after.merges <= before.merges || after.pages_merged == 0)
+  {
+    TracePrintf(0, "Identical pages were not merged\n");
+    Exit(1);
+  }
+
+  for (int i = 0; i < NUM_CHILDREN; i++)
+  {
+    if (Wait(&status) < 0 || status != 0)
+    {
+      TracePrintf(0, "A child failed with status %d\n", status);
+      Exit(1);
+    }
+  }
+
+  MergeControl(-1, &after);
+  if (after.splits <= before.splits)
+  {
+    TracePrintf(0, "Writes to merged pages were not split\n");
+    Exit(1);
+  }
+
+  // With merging off the scan count stays put
+  MergeControl(0, &before);
+  Delay(10);
+  MergeControl(-1, &after);
+  if (after.scan_rate != 0 || after.pages_scanned != before.pages_scanned)
+  {
+    TracePrintf(0, "Merger kept scanning after being turned off\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Merge tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,70 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Boot with sched=mlfq. Hogs sink to the bottom level while the sleeper,
+// which blocks every tick, stays on top and keeps getting the CPU.
+
+#define NUM_HOGS 3
+#define NUM_NAPS 20
+
+static void Hog(void)
+{
+  for (volatile unsigned int i = 0;; i++)
+  {
+  }
+}
+
+static void Sleeper(void)
+{
+  for (int i = 0; i < NUM_NAPS; i++)
+  {
+    Delay(1);
+  }
+  Exit(0);
+}
+
+int main(void)
+{
+  int hogs[NUM_HOGS];
+  int status;
+
+  TracePrintf(0, "Hello, mlfq!\n");
+
+  for (int i = 0; i < NUM_HOGS; i++)
+  {
+    hogs[i] = Fork();
+    if (hogs[i] == 0)
+    {
+      Hog();
+    }
+  }
+
+  // Give the hogs time to use up their quanta and be demoted
+  Delay(10);
+  int sleeper = Fork();
+  if (sleeper == 0)
+  {
+    Sleeper();
+  }
+
+  // The hogs never exit on their own, so the sleeper must be first
+  int first = Wait(&status);
+  if (first != sleeper || status != 0)
+  {
+    TracePrintf(0, "Wait returned %d status %d, expected the sleeper %d\n", first, status, sleeper);
+    Exit(1);
+  }
+  TracePrintf(0, "Sleeper finished %d naps beside %d hogs\n", NUM_NAPS, NUM_HOGS);
+
+  for (int i = 0; i < NUM_HOGS; i++)
+  {
+    Kill(hogs[i]);
+  }
+  for (int i = 0; i < NUM_HOGS; i++)
+  {
+    Wait(&status);
+  }
+
+  TracePrintf(0, "MLFQ tests passed\n");
+  Exit(0);
+}
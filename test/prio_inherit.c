@@ -0,0 +1,112 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Boot with sched=prio. Without inheritance the medium hog keeps the low
+// priority lock holder off the CPU forever and the test hangs.
+
+#define SPIN_LOOPS 20000000
+
+// Takes the lock, drops to low priority, then spins for the given loops or forever
+static int StartHolder(int lock, int pipe, int loops)
+{
+  int pid = Fork();
+  if (pid == 0)
+  {
+    // Lock first: once below the hog this child may not run again until a waiter boosts it
+    Acquire(lock);
+    PipeWrite(pipe, "L", 1);
+    SetPriority(0, 24);
+    for (volatile int i = 0; loops < 0 || i < loops; i++)
+    {
+    }
+    Release(lock);
+    Exit(0);
+  }
+  char tag;
+  PipeRead(pipe, &tag, 1);
+  Delay(1);
+  return pid;
+}
+
+static int StartWaiter(int lock)
+{
+  int pid = Fork();
+  if (pid == 0)
+  {
+    Acquire(lock);
+    Release(lock);
+    Exit(0);
+  }
+  return pid;
+}
+
+// Reaps two children and checks each exited with the expected status
+static void ReapPair(int a, int a_status, int b, int b_status, char *what)
+{
+  int status;
+  for (int i = 0; i < 2; i++)
+  {
+    int pid = Wait(&status);
+    if ((pid == a && status != a_status) || (pid == b && status != b_status) || (pid != a && pid != b))
+    {
+      TracePrintf(0, "%s: child %d exited with %d\n", what, pid, status);
+      Exit(1);
+    }
+  }
+  TracePrintf(0, "%s passed\n", what);
+}
+
+int main(void)
+{
+  int lock;
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, priority inheritance!\n");
+  LockInit(&lock);
+  PipeInit(&pipe);
+
+  int medium = Fork();
+  if (medium == 0)
+  {
+    SetPriority(0, 20);
+    for (;;)
+    {
+    }
+  }
+
+  // The waiter lends its priority so the holder can finish despite the hog
+  int holder = StartHolder(lock, pipe, SPIN_LOOPS);
+  int waiter = StartWaiter(lock);
+  ReapPair(holder, 0, waiter, 0, "Inversion");
+
+  // Killing a boosted holder while it sits on the ready queue hands the lock on
+  holder = StartHolder(lock, pipe, -1);
+  waiter = StartWaiter(lock);
+  Delay(2);
+  Kill(holder);
+  ReapPair(holder, -1, waiter, 0, "Killed holder");
+
+  // Scheduling still works afterwards
+  Kill(medium);
+  Wait(&status);
+  int child = Fork();
+  if (child == 0)
+  {
+    Delay(1);
+    Exit(GetPriority(0));
+  }
+  if (Wait(&status) != child || status != PRIO_DEFAULT)
+  {
+    TracePrintf(0, "Child after the kill ran at priority %d\n", status);
+    Exit(1);
+  }
+  if (Acquire(lock) != 0 || Release(lock) != 0)
+  {
+    TracePrintf(0, "Lock unusable after its holder was killed\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Priority inheritance tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,96 @@
+#include <yuser.h>
+#include "yext.h"
+
+// Boot with sched=prio so the ordering check holds.
+
+#define SPIN_LOOPS 20000000
+
+static void Spin(void)
+{
+  for (volatile int i = 0; i < SPIN_LOOPS; i++)
+  {
+  }
+}
+
+int main(void)
+{
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, priority!\n");
+
+  if (GetPriority(0) != PRIO_DEFAULT)
+  {
+    TracePrintf(0, "Init started at priority %d\n", GetPriority(0));
+    Exit(1);
+  }
+  if (SetPriority(0, -1) != -1 || SetPriority(0, PRIO_LEVELS) != -1)
+  {
+    TracePrintf(0, "Out of range priority accepted\n");
+    Exit(1);
+  }
+  if (SetPriority(0, PRIO_DEFAULT - 1) != -1)
+  {
+    TracePrintf(0, "Init raised its own priority\n");
+    Exit(1);
+  }
+  if (GetPriority(GetPid() + 1000) != -1)
+  {
+    TracePrintf(0, "Read the priority of a process that is not our child\n");
+    Exit(1);
+  }
+
+  // A parent may lower a child, and the child passes its priority on
+  int child = Fork();
+  if (child == 0)
+  {
+    Delay(2);
+    int grandchild = Fork();
+    if (grandchild == 0)
+    {
+      Exit(GetPriority(0));
+    }
+    Wait(&status);
+    Exit(status);
+  }
+  if (SetPriority(child, 30) != 0 || GetPriority(child) != 30)
+  {
+    TracePrintf(0, "Could not lower child %d\n", child);
+    Exit(1);
+  }
+  if (Wait(&status) != child || status != 30)
+  {
+    TracePrintf(0, "Grandchild ran at priority %d, expected 30\n", status);
+    Exit(1);
+  }
+
+  // The low priority hog starts first but must finish last
+  PipeInit(&pipe);
+  if (Fork() == 0)
+  {
+    SetPriority(0, 24);
+    Spin();
+    PipeWrite(pipe, "L", 1);
+    Exit(0);
+  }
+  if (Fork() == 0)
+  {
+    Delay(2);
+    Spin();
+    PipeWrite(pipe, "H", 1);
+    Exit(0);
+  }
+  char order[2];
+  PipeRead(pipe, &order[0], 1);
+  PipeRead(pipe, &order[1], 1);
+  Wait(&status);
+  Wait(&status);
+  if (order[0] != 'H' || order[1] != 'L')
+  {
+    TracePrintf(0, "Hogs finished in order %c%c, expected HL\n", order[0], order[1]);
+    Exit(1);
+  }
+
+  TracePrintf(0, "Priority tests passed\n");
+  Exit(0);
+}
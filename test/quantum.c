@@ -0,0 +1,66 @@
+#include <yuser.h>
+#include "yext.h"
+
+int main(void)
+{
+  int status;
+
+  TracePrintf(0, "Hello, quantum!\n");
+
+  // 0 reads the quantum without changing it
+  int boot = SetQuantum(0);
+  if (boot < 1 || SetQuantum(0) != boot)
+  {
+    TracePrintf(0, "SetQuantum(0) returned %d\n", boot);
+    Exit(1);
+  }
+  if (SetQuantum(-1) != -1)
+  {
+    TracePrintf(0, "Negative quantum accepted\n");
+    Exit(1);
+  }
+
+  // Each change returns the quantum it replaced
+  if (SetQuantum(5) != boot || SetQuantum(2) != 5 || SetQuantum(0) != 2)
+  {
+    TracePrintf(0, "SetQuantum did not return the previous quantum\n");
+    Exit(1);
+  }
+
+  // Two hogs still share the CPU with a longer quantum
+  SetQuantum(10);
+  int pipe;
+  PipeInit(&pipe);
+  for (int i = 0; i < 2; i++)
+  {
+    if (Fork() == 0)
+    {
+      for (volatile int j = 0; j < 20000000; j++)
+      {
+      }
+      PipeWrite(pipe, &i, sizeof(i));
+      Exit(0);
+    }
+  }
+  int done;
+  PipeRead(pipe, &done, sizeof(done));
+  PipeRead(pipe, &done, sizeof(done));
+  Wait(&status);
+  Wait(&status);
+
+  // Any other process may read the quantum but not change it
+  int child = Fork();
+  if (child == 0)
+  {
+    Exit((SetQuantum(0) == 10 && SetQuantum(3) == -1) ? 0 : 2);
+  }
+  if (Wait(&status) != child || status != 0)
+  {
+    TracePrintf(0, "Child of init changed the quantum\n");
+    Exit(1);
+  }
+
+  SetQuantum(boot);
+  TracePrintf(0, "Quantum tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,102 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_PERIODS 10
+
+// Sleeps through its periods beside a hog and exits with its missed deadline count
+static int StartPeriodic(void)
+{
+  int pid = Fork();
+  if (pid == 0)
+  {
+    // Give the parent time to make this child real-time
+    Delay(5);
+    for (int i = 0; i < NUM_PERIODS; i++)
+    {
+      WaitPeriod();
+    }
+    Exit(DeadlineMisses(0));
+  }
+  return pid;
+}
+
+int main(void)
+{
+  int status;
+
+  TracePrintf(0, "Hello, realtime!\n");
+
+  if (WaitPeriod() != -1)
+  {
+    TracePrintf(0, "WaitPeriod succeeded for a normal process\n");
+    Exit(1);
+  }
+  if (SetRealTime(0, 10, 0) != -1 || SetRealTime(0, 10, 11) != -1 || SetRealTime(0, -1, 1) != -1)
+  {
+    TracePrintf(0, "Invalid period or budget accepted\n");
+    Exit(1);
+  }
+
+  // A full budget would leave nothing for normal processes
+  if (SetRealTime(0, 10, 10) != -1)
+  {
+    TracePrintf(0, "Admitted 100%% utilization\n");
+    Exit(1);
+  }
+
+  int hog = Fork();
+  if (hog == 0)
+  {
+    for (;;)
+    {
+    }
+  }
+
+  // 50% and 40% fill the 90% cap; even 1% more is refused
+  int first = StartPeriodic();
+  int second = StartPeriodic();
+  if (SetRealTime(first, 10, 5) != 0 || SetRealTime(second, 10, 4) != 0)
+  {
+    TracePrintf(0, "Could not admit 90%% utilization\n");
+    Exit(1);
+  }
+  if (SetRealTime(0, 100, 1) != -1)
+  {
+    TracePrintf(0, "Admitted a reservation beyond the cap\n");
+    Exit(1);
+  }
+
+  for (int i = 0; i < 2; i++)
+  {
+    int pid = Wait(&status);
+    if (status != 0)
+    {
+      TracePrintf(0, "Periodic child %d missed %d deadlines beside a hog\n", pid, status);
+      Exit(1);
+    }
+  }
+
+  // Exiting gave the reservations back
+  if (SetRealTime(0, 100, 1) != 0)
+  {
+    TracePrintf(0, "Reservations of exited children were not released\n");
+    Exit(1);
+  }
+
+  // Sleeping past a deadline counts as a miss
+  SetRealTime(0, 10, 2);
+  Delay(25);
+  WaitPeriod();
+  if (DeadlineMisses(0) < 1)
+  {
+    TracePrintf(0, "Overrunning a period was not counted as a miss\n");
+    Exit(1);
+  }
+  SetRealTime(0, 0, 0);
+
+  Kill(hog);
+  Wait(&status);
+
+  TracePrintf(0, "Real-time tests passed\n");
+  Exit(0);
+}
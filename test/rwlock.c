@@ -0,0 +1,108 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_READERS 3
+
+int main(void)
+{
+  int rwlock;
+  int pipe;
+  int status;
+  char tag;
+
+  TracePrintf(0, "Hello, rwlock!\n");
+
+  if (RWLockInit(&rwlock) != 0)
+  {
+    TracePrintf(0, "RWLockInit failed\n");
+    Exit(1);
+  }
+  if (ReleaseRW(rwlock) != -1 || AcquireRead(rwlock + 1) != -1)
+  {
+    TracePrintf(0, "Released an unheld lock or used a bad ID\n");
+    Exit(1);
+  }
+  PipeInit(&pipe);
+
+  // Readers share the lock: all of them get in while the others still hold it
+  for (int i = 0; i < NUM_READERS; i++)
+  {
+    if (Fork() == 0)
+    {
+      AcquireRead(rwlock);
+      PipeWrite(pipe, "R", 1);
+      Delay(5);
+      PipeWrite(pipe, "r", 1);
+      ReleaseRW(rwlock);
+      Exit(0);
+    }
+  }
+  for (int i = 0; i < 2 * NUM_READERS; i++)
+  {
+    PipeRead(pipe, &tag, 1);
+    if (tag != ((i < NUM_READERS) ? 'R' : 'r'))
+    {
+      TracePrintf(0, "Report %d was %c: readers did not overlap\n", i, tag);
+      Exit(1);
+    }
+  }
+  for (int i = 0; i < NUM_READERS; i++)
+  {
+    Wait(&status);
+  }
+
+  // A writer excludes readers, and a waiting writer holds back new readers
+  AcquireRead(rwlock);
+  if (Fork() == 0)
+  {
+    AcquireWrite(rwlock);
+    PipeWrite(pipe, "W", 1);
+    ReleaseRW(rwlock);
+    Exit(0);
+  }
+  Delay(2);
+  if (Fork() == 0)
+  {
+    AcquireRead(rwlock);
+    PipeWrite(pipe, "R", 1);
+    ReleaseRW(rwlock);
+    Exit(0);
+  }
+  Delay(2);
+  ReleaseRW(rwlock);
+  char order[2];
+  PipeRead(pipe, &order[0], 1);
+  PipeRead(pipe, &order[1], 1);
+  Wait(&status);
+  Wait(&status);
+  if (order[0] != 'W' || order[1] != 'R')
+  {
+    TracePrintf(0, "Got %c%c, expected the queued writer before the late reader\n", order[0], order[1]);
+    Exit(1);
+  }
+
+  // The writer's own hold is exclusive
+  AcquireWrite(rwlock);
+  if (Fork() == 0)
+  {
+    AcquireRead(rwlock);
+    PipeWrite(pipe, "R", 1);
+    ReleaseRW(rwlock);
+    Exit(0);
+  }
+  Delay(2);
+  PipeWrite(pipe, "W", 1);
+  ReleaseRW(rwlock);
+  PipeRead(pipe, &order[0], 1);
+  PipeRead(pipe, &order[1], 1);
+  Wait(&status);
+  if (order[0] != 'W' || order[1] != 'R')
+  {
+    TracePrintf(0, "A reader got in while the lock was held for writing\n");
+    Exit(1);
+  }
+
+  Reclaim(rwlock);
+  TracePrintf(0, "RWLock tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,98 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_WORKERS 4
+#define NUM_UNITS 2
+
+int main(void)
+{
+  int sem;
+  int slots;
+  int pipe;
+  int status;
+  char tag;
+
+  TracePrintf(0, "Hello, semaphore!\n");
+
+  if (SemaphoreInit(&sem, -1) != -1)
+  {
+    TracePrintf(0, "Negative count accepted\n");
+    Exit(1);
+  }
+  if (SemaphoreInit(&sem, 0) != 0 || SemaphoreUp(sem, 0) != -1)
+  {
+    TracePrintf(0, "SemaphoreUp accepted a zero count\n");
+    Exit(1);
+  }
+  PipeInit(&pipe);
+
+  // Banked units are taken without blocking
+  SemaphoreUp(sem, 3);
+  for (int i = 0; i < 3; i++)
+  {
+    if (SemaphoreDown(sem) != 0)
+    {
+      TracePrintf(0, "SemaphoreDown %d failed\n", i);
+      Exit(1);
+    }
+  }
+
+  // One SemaphoreUp wakes as many waiters as it has units
+  for (int i = 0; i < NUM_WORKERS; i++)
+  {
+    if (Fork() == 0)
+    {
+      SemaphoreDown(sem);
+      PipeWrite(pipe, "D", 1);
+      Exit(0);
+    }
+  }
+  Delay(3);
+  SemaphoreUp(sem, NUM_WORKERS);
+  for (int i = 0; i < NUM_WORKERS; i++)
+  {
+    PipeRead(pipe, &tag, 1);
+    Wait(&status);
+  }
+
+  // A semaphore of NUM_UNITS lets at most that many workers in at once
+  SemaphoreInit(&slots, NUM_UNITS);
+  for (int i = 0; i < NUM_WORKERS; i++)
+  {
+    if (Fork() == 0)
+    {
+      SemaphoreDown(slots);
+      PipeWrite(pipe, "+", 1);
+      Delay(3);
+      PipeWrite(pipe, "-", 1);
+      SemaphoreUp(slots, 1);
+      Exit(0);
+    }
+  }
+  int inside = 0;
+  for (int i = 0; i < 2 * NUM_WORKERS; i++)
+  {
+    PipeRead(pipe, &tag, 1);
+    inside += (tag == '+') ? 1 : -1;
+    if (inside > NUM_UNITS)
+    {
+      TracePrintf(0, "%d workers inside a %d unit semaphore\n", inside, NUM_UNITS);
+      Exit(1);
+    }
+  }
+  for (int i = 0; i < NUM_WORKERS; i++)
+  {
+    Wait(&status);
+  }
+
+  Reclaim(sem);
+  Reclaim(slots);
+  if (SemaphoreDown(sem) != -1)
+  {
+    TracePrintf(0, "Reclaimed semaphore still usable\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Semaphore tests passed\n");
+  Exit(0);
+}
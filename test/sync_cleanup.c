@@ -0,0 +1,87 @@
+#include <yuser.h>
+
+// Creates a lock in a child, sends its ID back, and exits. If hold is set the
+// child exits while still holding the lock.
+static int LockFromChild(int pipe, int hold, int linger)
+{
+  int pid = Fork();
+  if (pid == 0)
+  {
+    int lock;
+    LockInit(&lock);
+    if (hold)
+    {
+      Acquire(lock);
+    }
+    PipeWrite(pipe, &lock, sizeof(lock));
+    Delay(linger);
+    Exit(0);
+  }
+  int lock;
+  PipeRead(pipe, &lock, sizeof(lock));
+  return lock;
+}
+
+int main(void)
+{
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, sync cleanup!\n");
+  PipeInit(&pipe);
+
+  // A lock nobody else touched dies with its creator
+  int orphan = LockFromChild(pipe, 0, 0);
+  Wait(&status);
+  if (Acquire(orphan) != -1)
+  {
+    TracePrintf(0, "Lock %d outlived the only process that used it\n", orphan);
+    Exit(1);
+  }
+
+  // A lock we used survives its creator
+  int shared = LockFromChild(pipe, 0, 5);
+  if (Acquire(shared) != 0 || Release(shared) != 0)
+  {
+    TracePrintf(0, "Could not use lock %d from our child\n", shared);
+    Exit(1);
+  }
+  Wait(&status);
+  if (Acquire(shared) != 0 || Release(shared) != 0)
+  {
+    TracePrintf(0, "Lock %d we used was reclaimed when its creator exited\n", shared);
+    Exit(1);
+  }
+  Reclaim(shared);
+
+  // A lock held at exit is released to the process blocked on it
+  int held = LockFromChild(pipe, 1, 5);
+  if (Acquire(held) != 0)
+  {
+    TracePrintf(0, "Lock %d was not released when its holder exited\n", held);
+    Exit(1);
+  }
+  Release(held);
+  Wait(&status);
+  Reclaim(held);
+
+  // Objects created before a fork survive the child
+  int lock;
+  LockInit(&lock);
+  int child = Fork();
+  if (child == 0)
+  {
+    Acquire(lock);
+    Exit(0);
+  }
+  Wait(&status);
+  if (Acquire(lock) != 0 || Release(lock) != 0)
+  {
+    TracePrintf(0, "Our lock %d was lost when a child exited holding it\n", lock);
+    Exit(1);
+  }
+  Reclaim(lock);
+
+  TracePrintf(0, "Sync cleanup tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,82 @@
+#include <yuser.h>
+
+#define NUM_LOCKS 100 // More than the table's initial 64 slots
+
+int main(void)
+{
+  int lock;
+  int cvar;
+  int pipe;
+  int locks[NUM_LOCKS];
+  char byte = 'x';
+
+  TracePrintf(0, "Hello, sync IDs!\n");
+
+  // A reclaimed ID stays dead even once its slot is reused
+  LockInit(&lock);
+  int stale = lock;
+  Reclaim(lock);
+  if (Acquire(stale) != -1 || Reclaim(stale) != -1)
+  {
+    TracePrintf(0, "Reclaimed lock %d still usable\n", stale);
+    Exit(1);
+  }
+  LockInit(&lock);
+  if (lock == stale || Acquire(stale) != -1)
+  {
+    TracePrintf(0, "New lock %d is reachable through stale ID %d\n", lock, stale);
+    Exit(1);
+  }
+  if (Acquire(lock) != 0 || Release(lock) != 0)
+  {
+    TracePrintf(0, "Lock %d in a reused slot does not work\n", lock);
+    Exit(1);
+  }
+
+  // Each call checks the type encoded in the ID
+  CvarInit(&cvar);
+  PipeInit(&pipe);
+  if (Acquire(cvar) != -1 || CvarSignal(lock) != -1 || PipeWrite(lock, &byte, 1) != -1 ||
+      PipeRead(cvar, &byte, 1) != -1)
+  {
+    TracePrintf(0, "An ID of the wrong type was accepted\n");
+    Exit(1);
+  }
+  if (Acquire(0) != -1 || Acquire(-1) != -1 || Acquire(0x7FFFFFFF) != -1)
+  {
+    TracePrintf(0, "A made-up ID was accepted\n");
+    Exit(1);
+  }
+
+  // The table grows past its initial size and every object stays distinct
+  for (int i = 0; i < NUM_LOCKS; i++)
+  {
+    if (LockInit(&locks[i]) != 0)
+    {
+      TracePrintf(0, "LockInit %d failed\n", i);
+      Exit(1);
+    }
+    for (int j = 0; j < i; j++)
+    {
+      if (locks[j] == locks[i])
+      {
+        TracePrintf(0, "Locks %d and %d share ID %d\n", j, i, locks[i]);
+        Exit(1);
+      }
+    }
+  }
+  for (int i = 0; i < NUM_LOCKS; i++)
+  {
+    if (Acquire(locks[i]) != 0 || Release(locks[i]) != 0 || Reclaim(locks[i]) != 0)
+    {
+      TracePrintf(0, "Lock %d unusable after the table grew\n", locks[i]);
+      Exit(1);
+    }
+  }
+
+  Reclaim(lock);
+  Reclaim(cvar);
+  Reclaim(pipe);
+  TracePrintf(0, "Sync ID tests passed\n");
+  Exit(0);
+}
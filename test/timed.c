@@ -0,0 +1,106 @@
+#include <yuser.h>
+#include "yext.h"
+
+int main(void)
+{
+  int lock;
+  int cvar;
+  int pipe;
+  int status;
+  char buffer[16];
+
+  TracePrintf(0, "Hello, timed waits!\n");
+  LockInit(&lock);
+  CvarInit(&cvar);
+  PipeInit(&pipe);
+
+  if (AcquireTimed(lock, -1) != -1 || PipeReadTimed(pipe, buffer, 1, -1) != -1)
+  {
+    TracePrintf(0, "Negative timeout accepted\n");
+    Exit(1);
+  }
+
+  // A lock held past the timeout times out, then is handed over when released
+  int holder = Fork();
+  if (holder == 0)
+  {
+    Acquire(lock);
+    Delay(20);
+    Release(lock);
+    Exit(0);
+  }
+  Delay(2);
+  if (AcquireTimed(lock, 3) != TIMEOUT)
+  {
+    TracePrintf(0, "AcquireTimed of a held lock did not time out\n");
+    Exit(1);
+  }
+  if (AcquireTimed(lock, 100) != 0 || Release(lock) != 0)
+  {
+    TracePrintf(0, "AcquireTimed did not get the released lock\n");
+    Exit(1);
+  }
+  Wait(&status);
+
+  // A timed cvar wait needs the lock, and holds it again after timing out
+  if (CvarWaitTimed(cvar, lock, 3) != -1)
+  {
+    TracePrintf(0, "CvarWaitTimed without the lock was accepted\n");
+    Exit(1);
+  }
+  Acquire(lock);
+  if (CvarWaitTimed(cvar, lock, 3) != TIMEOUT || Release(lock) != 0)
+  {
+    TracePrintf(0, "Unsignalled CvarWaitTimed did not time out holding the lock\n");
+    Exit(1);
+  }
+
+  // Once signalled the wait succeeds, even if the lock comes back after the timeout
+  Acquire(lock);
+  int signaller = Fork();
+  if (signaller == 0)
+  {
+    Acquire(lock);
+    CvarSignal(cvar);
+    Delay(10);
+    Release(lock);
+    Exit(0);
+  }
+  Delay(2);
+  if (CvarWaitTimed(cvar, lock, 5) != 0 || Release(lock) != 0)
+  {
+    TracePrintf(0, "Signalled CvarWaitTimed did not succeed\n");
+    Exit(1);
+  }
+  Wait(&status);
+
+  // An empty pipe times out; data arriving in time is returned
+  if (PipeReadTimed(pipe, buffer, sizeof(buffer), 3) != TIMEOUT)
+  {
+    TracePrintf(0, "PipeReadTimed of an empty pipe did not time out\n");
+    Exit(1);
+  }
+  int writer = Fork();
+  if (writer == 0)
+  {
+    Delay(2);
+    PipeWrite(pipe, "hi", 2);
+    Exit(0);
+  }
+  if (PipeReadTimed(pipe, buffer, sizeof(buffer), 50) != 2)
+  {
+    TracePrintf(0, "PipeReadTimed missed data written in time\n");
+    Exit(1);
+  }
+  Wait(&status);
+
+  // Nobody types on terminal 1 during the test
+  if (TtyReadTimed(1, buffer, sizeof(buffer), 3) != TIMEOUT)
+  {
+    TracePrintf(0, "TtyReadTimed without input did not time out\n");
+    Exit(1);
+  }
+
+  TracePrintf(0, "Timed wait tests passed\n");
+  Exit(0);
+}
@@ -0,0 +1,47 @@
+#include <yuser.h>
+#include <hardware.h>
+#include "yext.h"
+
+// Manual test: type lines on terminal 1 while hogs load the CPU. Each echo
+// should appear within a quantum of pressing return, not after every hog
+// has had its turn.
+
+#define NUM_HOGS 6
+#define NUM_LINES 5
+
+int main()
+{
+  int terminal = 1;
+  int hogs[NUM_HOGS];
+  char buffer[100];
+  int status;
+
+  for (int i = 0; i < NUM_HOGS; i++)
+  {
+    hogs[i] = Fork();
+    if (hogs[i] == 0)
+    {
+      for (;;)
+      {
+      }
+    }
+  }
+
+  TtyPrintf(terminal, "=== TTY Boost Test: %d hogs running ===\n", NUM_HOGS);
+  for (int i = 0; i < NUM_LINES; i++)
+  {
+    TtyPrintf(terminal, "Line %d> ", i + 1);
+    int bytes_read = TtyRead(terminal, buffer, sizeof(buffer) - 1);
+    buffer[bytes_read] = '\0';
+    TtyPrintf(terminal, "Echo: %s", buffer);
+  }
+
+  for (int i = 0; i < NUM_HOGS; i++)
+  {
+    Kill(hogs[i]);
+    Wait(&status);
+  }
+
+  TtyPrintf(terminal, "\n=== Test completed successfully ===\n");
+  Exit(0);
+}
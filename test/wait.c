@@ -0,0 +1,56 @@
+#include <yuser.h>
+
+#define NUM_CHILDREN 10
+
+int main(void)
+{
+  int pids[NUM_CHILDREN];
+  int status;
+
+  TracePrintf(0, "Hello, wait!\n");
+
+  // Fork a batch of children that exit right away, so they pile up as zombies
+  for (int i = 0; i < NUM_CHILDREN; i++)
+  {
+    pids[i] = Fork();
+    if (pids[i] == 0)
+    {
+      Exit(100 + i);
+    }
+    TracePrintf(0, "Forked child %d with pid %d\n", i, pids[i]);
+  }
+
+  // Let every child exit before we start reaping
+  Delay(5);
+
+  for (int i = 0; i < NUM_CHILDREN; i++)
+  {
+    int pid = Wait(&status);
+    TracePrintf(0, "Reaped child %d with status %d\n", pid, status);
+  }
+
+  // This child exits while we are already blocked in Wait
+  int late = Fork();
+  if (late == 0)
+  {
+    Delay(3);
+    Exit(42);
+  }
+  int pid = Wait(&status);
+  if (pid != late || status != 42)
+  {
+    TracePrintf(0, "Wait returned pid %d status %d, expected pid %d status 42\n", pid, status, late);
+    Exit(1);
+  }
+
+  // No children left, so this should not block
+  int rc = Wait(&status);
+  if (rc != -1)
+  {
+    TracePrintf(0, "Wait with no children returned %d instead of -1\n", rc);
+    Exit(1);
+  }
+  TracePrintf(0, "Wait with no children returned -1 as expected\n");
+
+  Exit(0);
+}
@@ -0,0 +1,275 @@
+#ifndef YEXT_H
+#define YEXT_H
+
+#include <yuser.h>
+
+/*
+ * User-library stubs for the kernel calls this kernel adds beyond yalnix.h.
+ *
+ * libyuser has no stubs for these, so each one enters the kernel through
+ * the framework's Custom0 trap with its call code as the first argument,
+ * and TrapKernelHandler decodes it. The call codes mirror syscalls.h;
+ * constants and structures a call exchanges with the kernel mirror the
+ * kernel header named next to them. Keep both in step with the kernel.
+ */
+
+#define YALNIX_EXT_BASE 0x100
+
+// Kill (syscalls.h)
+#define YALNIX_KILL (YALNIX_EXT_BASE + 0)
+
+static inline int Kill(int pid)
+{
+  return Custom0(YALNIX_KILL, pid, 0, 0);
+}
+
+// Resource limits (process.h)
+#define YALNIX_SET_LIMIT (YALNIX_EXT_BASE + 1)
+#define YALNIX_GET_LIMIT (YALNIX_EXT_BASE + 2)
+#define LIMIT_FRAMES 0       // Maximum resident region 1 frames
+#define LIMIT_CPU_TICKS 1    // Maximum clock ticks of CPU time
+#define LIMIT_SYNC_OBJECTS 2 // Maximum live synchronization objects
+#define LIMIT_CHILDREN 3     // Maximum children not yet reaped
+#define LIMIT_UNLIMITED 0x7FFFFFFF // Limit value meaning no limit
+
+static inline int SetLimit(int pid, int resource, int value)
+{
+  return Custom0(YALNIX_SET_LIMIT, pid, resource, value);
+}
+
+static inline int GetLimit(int pid, int resource)
+{
+  return Custom0(YALNIX_GET_LIMIT, pid, resource, 0);
+}
+
+// Batch fork (syscalls.h)
+#define YALNIX_FORKN (YALNIX_EXT_BASE + 3)
+#define FORKN_MAX 64 // Most children a single ForkN can create
+
+static inline int ForkN(int n, int *pids)
+{
+  return Custom0(YALNIX_FORKN, n, (int)pids, 0);
+}
+
+// Page merging (merge.h)
+#define YALNIX_MERGE_CTL (YALNIX_EXT_BASE + 4)
+typedef struct merge_stats
+{
+  int scan_rate;     // Pages examined per idle tick, 0 if merging is off
+  int pages_scanned; // Total pages hashed since boot
+  int pages_merged;  // Mappings currently sharing a frame with another mapping
+  int merges;        // Total merges since boot
+  int splits;        // Total copy-on-write splits since boot
+} merge_stats_t;
+
+static inline int MergeControl(int scan_rate, merge_stats_t *stats)
+{
+  return Custom0(YALNIX_MERGE_CTL, scan_rate, (int)stats, 0);
+}
+
+// Fixed priorities (scheduler.h)
+#define YALNIX_SET_PRIORITY (YALNIX_EXT_BASE + 5)
+#define YALNIX_GET_PRIORITY (YALNIX_EXT_BASE + 6)
+#define PRIO_LEVELS 32  // Priorities run from 0 (highest) to PRIO_LEVELS - 1
+#define PRIO_DEFAULT 16 // Priority of init; children inherit their parent's
+
+static inline int SetPriority(int pid, int priority)
+{
+  return Custom0(YALNIX_SET_PRIORITY, pid, priority, 0);
+}
+
+static inline int GetPriority(int pid)
+{
+  return Custom0(YALNIX_GET_PRIORITY, pid, 0, 0);
+}
+
+// Scheduling groups (scheduler.h)
+#define YALNIX_GROUP_CREATE (YALNIX_EXT_BASE + 7)
+#define YALNIX_GROUP_MOVE (YALNIX_EXT_BASE + 8)
+#define YALNIX_GROUP_TICKS (YALNIX_EXT_BASE + 9)
+#define YALNIX_GROUP_DESTROY (YALNIX_EXT_BASE + 10)
+#define MAX_SCHED_GROUPS 16      // Scheduling groups, including the default group 0
+#define STRIDE_MAX_TICKETS 10000 // Most tickets a group can hold
+
+static inline int GroupCreate(int tickets)
+{
+  return Custom0(YALNIX_GROUP_CREATE, tickets, 0, 0);
+}
+
+static inline int GroupMove(int pid, int group)
+{
+  return Custom0(YALNIX_GROUP_MOVE, pid, group, 0);
+}
+
+static inline int GroupTicks(int group)
+{
+  return Custom0(YALNIX_GROUP_TICKS, group, 0, 0);
+}
+
+static inline int GroupDestroy(int group)
+{
+  return Custom0(YALNIX_GROUP_DESTROY, group, 0, 0);
+}
+
+// Real-time reservations (scheduler.h)
+#define YALNIX_SET_REALTIME (YALNIX_EXT_BASE + 11)
+#define YALNIX_WAIT_PERIOD (YALNIX_EXT_BASE + 12)
+#define YALNIX_DEADLINE_MISSES (YALNIX_EXT_BASE + 13)
+
+static inline int SetRealTime(int pid, int period, int budget)
+{
+  return Custom0(YALNIX_SET_REALTIME, pid, period, budget);
+}
+
+static inline int WaitPeriod(void)
+{
+  return Custom0(YALNIX_WAIT_PERIOD, 0, 0, 0);
+}
+
+static inline int DeadlineMisses(int pid)
+{
+  return Custom0(YALNIX_DEADLINE_MISSES, pid, 0, 0);
+}
+
+// Time quantum (scheduler.h)
+#define YALNIX_SET_QUANTUM (YALNIX_EXT_BASE + 14)
+
+static inline int SetQuantum(int ticks)
+{
+  return Custom0(YALNIX_SET_QUANTUM, ticks, 0, 0);
+}
+
+// Yield and scheduling hints (scheduler.h)
+#define YALNIX_YIELD (YALNIX_EXT_BASE + 15)
+#define YALNIX_SCHED_HINT (YALNIX_EXT_BASE + 16)
+#define SCHED_HINT_NORMAL 0      // No preference
+#define SCHED_HINT_BATCH 1       // Throughput over latency
+#define SCHED_HINT_INTERACTIVE 2 // Latency over throughput
+
+static inline int Yield(void)
+{
+  return Custom0(YALNIX_YIELD, 0, 0, 0);
+}
+
+static inline int SchedHint(int hint)
+{
+  return Custom0(YALNIX_SCHED_HINT, hint, 0, 0);
+}
+
+// Reader-writer locks (synchronization.h)
+#define YALNIX_RWLOCK_INIT (YALNIX_EXT_BASE + 17)
+#define YALNIX_ACQUIRE_READ (YALNIX_EXT_BASE + 18)
+#define YALNIX_ACQUIRE_WRITE (YALNIX_EXT_BASE + 19)
+#define YALNIX_RELEASE_RW (YALNIX_EXT_BASE + 20)
+
+static inline int RWLockInit(int *rwlock_idp)
+{
+  return Custom0(YALNIX_RWLOCK_INIT, (int)rwlock_idp, 0, 0);
+}
+
+static inline int AcquireRead(int rwlock_id)
+{
+  return Custom0(YALNIX_ACQUIRE_READ, rwlock_id, 0, 0);
+}
+
+static inline int AcquireWrite(int rwlock_id)
+{
+  return Custom0(YALNIX_ACQUIRE_WRITE, rwlock_id, 0, 0);
+}
+
+static inline int ReleaseRW(int rwlock_id)
+{
+  return Custom0(YALNIX_RELEASE_RW, rwlock_id, 0, 0);
+}
+
+// Counting semaphores (synchronization.h)
+// yalnix.h may already reserve codes for semaphores; only fill in the missing ones
+#ifndef YALNIX_SEM_INIT
+#define YALNIX_SEM_INIT (YALNIX_EXT_BASE + 21)
+#endif
+#ifndef YALNIX_SEM_DOWN
+#define YALNIX_SEM_DOWN (YALNIX_EXT_BASE + 22)
+#endif
+#ifndef YALNIX_SEM_UP
+#define YALNIX_SEM_UP (YALNIX_EXT_BASE + 23)
+#endif
+
+// Named apart from any SemInit/SemUp/SemDown libyuser declares, since SemaphoreUp takes a count
+static inline int SemaphoreInit(int *sem_idp, int count)
+{
+  return Custom0(YALNIX_SEM_INIT, (int)sem_idp, count, 0);
+}
+
+static inline int SemaphoreDown(int sem_id)
+{
+  return Custom0(YALNIX_SEM_DOWN, sem_id, 0, 0);
+}
+
+static inline int SemaphoreUp(int sem_id, int count)
+{
+  return Custom0(YALNIX_SEM_UP, sem_id, count, 0);
+}
+
+// Barriers (synchronization.h)
+#define YALNIX_BARRIER_INIT (YALNIX_EXT_BASE + 24)
+#define YALNIX_BARRIER_WAIT (YALNIX_EXT_BASE + 25)
+#define BARRIER_SERIAL 1 // BarrierWait result for the one process chosen per phase
+
+static inline int BarrierInit(int *barrier_idp, int parties)
+{
+  return Custom0(YALNIX_BARRIER_INIT, (int)barrier_idp, parties, 0);
+}
+
+static inline int BarrierWait(int barrier_id)
+{
+  return Custom0(YALNIX_BARRIER_WAIT, barrier_id, 0, 0);
+}
+
+// Timed waits (synchronization.h)
+#define YALNIX_ACQUIRE_TIMED (YALNIX_EXT_BASE + 26)
+#define YALNIX_CVAR_WAIT_TIMED (YALNIX_EXT_BASE + 27)
+#define YALNIX_PIPE_READ_TIMED (YALNIX_EXT_BASE + 28)
+#define YALNIX_TTY_READ_TIMED (YALNIX_EXT_BASE + 29)
+#define TIMEOUT (-3) // Returned by a timed wait that expired before it was satisfied
+
+static inline int AcquireTimed(int lock_id, int ticks)
+{
+  return Custom0(YALNIX_ACQUIRE_TIMED, lock_id, ticks, 0);
+}
+
+static inline int CvarWaitTimed(int cvar_id, int lock_id, int ticks)
+{
+  return Custom0(YALNIX_CVAR_WAIT_TIMED, cvar_id, lock_id, ticks);
+}
+
+// Custom0 has room for only three arguments, so the four-argument reads get a trap each
+static inline int PipeReadTimed(int pipe_id, void *buffer, int length, int ticks)
+{
+  return Custom1(pipe_id, (int)buffer, length, ticks);
+}
+
+static inline int TtyReadTimed(int tty_id, void *buffer, int length, int ticks)
+{
+  return Custom2(tty_id, (int)buffer, length, ticks);
+}
+
+// Lock contention counters (synchronization.h)
+#define YALNIX_LOCK_PROFILE (YALNIX_EXT_BASE + 30)
+#define LOCK_PROFILE_MAX 64 // Most locks one LockProfile call reports
+typedef struct lock_profile
+{
+  int id;              // ID of the lock
+  int acquisitions;    // Times the lock was taken
+  int contended;       // Times a process had to queue for it
+  int wait_ticks;      // Clock ticks spent queued, summed over all waiters
+  int max_wait_ticks;  // Longest single wait in clock ticks
+  int hold_ticks;      // Clock ticks the lock was held, summed over all holds
+  int max_queue_depth; // Most processes ever queued at once
+} lock_profile_t;
+
+static inline int LockProfile(int enable, lock_profile_t *stats, int count)
+{
+  return Custom0(YALNIX_LOCK_PROFILE, enable, (int)stats, count);
+}
+
+#endif // YEXT_H
@@ -0,0 +1,79 @@
+#include <yuser.h>
+#include "yext.h"
+
+#define NUM_YIELDS 50
+
+int main(void)
+{
+  int pipe;
+  int status;
+
+  TracePrintf(0, "Hello, yield!\n");
+
+  // With nothing else ready Yield returns at once
+  for (int i = 0; i < NUM_YIELDS; i++)
+  {
+    if (Yield() != 0)
+    {
+      TracePrintf(0, "Yield failed\n");
+      Exit(1);
+    }
+  }
+
+  // Two yielding children both make progress
+  PipeInit(&pipe);
+  for (char tag = 'a'; tag <= 'b'; tag++)
+  {
+    if (Fork() == 0)
+    {
+      for (int i = 0; i < NUM_YIELDS; i++)
+      {
+        PipeWrite(pipe, &tag, 1);
+        Yield();
+      }
+      Exit(0);
+    }
+  }
+  int counts[2] = {0, 0};
+  for (int i = 0; i < 2 * NUM_YIELDS; i++)
+  {
+    char tag;
+    PipeRead(pipe, &tag, 1);
+    counts[tag - 'a']++;
+  }
+  Wait(&status);
+  Wait(&status);
+  if (counts[0] != NUM_YIELDS || counts[1] != NUM_YIELDS)
+  {
+    TracePrintf(0, "Yielding children wrote %d and %d bytes\n", counts[0], counts[1]);
+    Exit(1);
+  }
+
+  // Each hint returns the one it replaced
+  if (SchedHint(-1) != -1 || SchedHint(SCHED_HINT_INTERACTIVE + 1) != -1)
+  {
+    TracePrintf(0, "Invalid hint accepted\n");
+    Exit(1);
+  }
+  if (SchedHint(SCHED_HINT_BATCH) != SCHED_HINT_NORMAL || SchedHint(SCHED_HINT_INTERACTIVE) != SCHED_HINT_BATCH)
+  {
+    TracePrintf(0, "SchedHint did not return the previous hint\n");
+    Exit(1);
+  }
+
+  // Children inherit the hint
+  int child = Fork();
+  if (child == 0)
+  {
+    Exit(SchedHint(SCHED_HINT_NORMAL));
+  }
+  if (Wait(&status) != child || status != SCHED_HINT_INTERACTIVE)
+  {
+    TracePrintf(0, "Child started with hint %d\n", status);
+    Exit(1);
+  }
+  SchedHint(SCHED_HINT_NORMAL);
+
+  TracePrintf(0, "Yield tests passed\n");
+  Exit(0);
+}
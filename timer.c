@@ -0,0 +1,78 @@
+#include "timer.h"
+#include "ykernel.h"
+#include "yalnix.h"
+
+static pcb_t *wheel[TIMER_WHEEL_SIZE]; // Each slot lists the timers expiring at ticks congruent to it
+static unsigned int now = 0;           // Clock ticks since boot
+
+void StartTimer(pcb_t *pcb, int ticks, timer_callback_t callback)
+{
+  CancelTimer(pcb);
+
+  pcb->timer_expires = now + ticks;
+  pcb->timer_callback = callback;
+  pcb->timer_armed = 1;
+
+  // Push onto the front of the slot's list
+  pcb_t **slot = &wheel[pcb->timer_expires % TIMER_WHEEL_SIZE];
+  pcb->timer_prev = NULL;
+  pcb->timer_next = *slot;
+  if (*slot != NULL)
+  {
+    (*slot)->timer_prev = pcb;
+  }
+  *slot = pcb;
+
+  TracePrintf(2, "StartTimer: pid %d expires at tick %u\n", pcb->pid, pcb->timer_expires);
+}
+
+void CancelTimer(pcb_t *pcb)
+{
+  if (!pcb->timer_armed)
+  {
+    return;
+  }
+
+  if (pcb->timer_prev != NULL)
+  {
+    pcb->timer_prev->timer_next = pcb->timer_next;
+  }
+  else
+  {
+    wheel[pcb->timer_expires % TIMER_WHEEL_SIZE] = pcb->timer_next;
+  }
+  if (pcb->timer_next != NULL)
+  {
+    pcb->timer_next->timer_prev = pcb->timer_prev;
+  }
+
+  pcb->timer_next = NULL;
+  pcb->timer_prev = NULL;
+  pcb->timer_armed = 0;
+}
+
+void TimerTick(void)
+{
+  now++;
+
+  pcb_t *next;
+  for (pcb_t *pcb = wheel[now % TIMER_WHEEL_SIZE]; pcb != NULL; pcb = next)
+  {
+    next = pcb->timer_next;
+
+    // Timers a full revolution or more away share the slot; leave them for later
+    if (pcb->timer_expires != now)
+    {
+      continue;
+    }
+
+    CancelTimer(pcb);
+    TracePrintf(2, "TimerTick: Timer for pid %d expired at tick %u\n", pcb->pid, now);
+    pcb->timer_callback(pcb);
+  }
+}
+
+unsigned int CurrentTick(void)
+{
+  return now;
+}
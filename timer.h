@@ -0,0 +1,49 @@
+#ifndef _TIMER_H
+#define _TIMER_H
+
+#include "process.h"
+
+#define TIMER_WHEEL_SIZE 64 // Slots in the timer wheel; a power of two keeps the modulo cheap
+
+/**
+ * Timer Callback
+ *
+ * Runs from the clock handler when a process's timer expires. The timer is
+ * already disarmed, so the callback may start a new one.
+ */
+typedef void (*timer_callback_t)(pcb_t *pcb);
+
+/**
+ * StartTimer - Arm a process's timer
+ *
+ * Each process has one timer. Starting it again replaces the pending one.
+ *
+ * @param pcb - The process the timer belongs to
+ * @param ticks - Clock ticks until expiry, at least 1
+ * @param callback - Called with the process when the timer expires
+ */
+void StartTimer(pcb_t *pcb, int ticks, timer_callback_t callback);
+
+/**
+ * CancelTimer - Disarm a process's timer if it is pending
+ *
+ * @param pcb - The process whose timer to cancel
+ */
+void CancelTimer(pcb_t *pcb);
+
+/**
+ * TimerTick - Advance the clock by one tick and fire expired timers
+ *
+ * Only the wheel slot for the new tick is examined, so the cost depends on
+ * the timers in that slot rather than on every sleeping process.
+ */
+void TimerTick(void);
+
+/**
+ * CurrentTick - Returns the number of clock ticks since boot
+ *
+ * @return Ticks since boot
+ */
+unsigned int CurrentTick(void);
+
+#endif // _TIMER_H
@@ -8,11 +8,33 @@
 #include "ykernel.h"
 #include "synchronization.h"
 #include "tty.h"
+#include "merge.h"
+#include "scheduler.h"
+#include "timer.h"
 
 void TrapKernelHandler(UserContext *uctxt)
 {
   int syscall_number = uctxt->code;
 
+  // Calls added beyond yalnix.h arrive through the framework's Custom0 trap,
+  // which carries the call code in regs[0] and up to three arguments after it
+  if (syscall_number == YALNIX_CUSTOM_0)
+  {
+    syscall_number = uctxt->regs[0];
+    uctxt->regs[0] = uctxt->regs[1];
+    uctxt->regs[1] = uctxt->regs[2];
+    uctxt->regs[2] = uctxt->regs[3];
+  }
+  // The two four-argument reads do not fit behind a call code, so they get a trap each
+  else if (syscall_number == YALNIX_CUSTOM_1)
+  {
+    syscall_number = YALNIX_PIPE_READ_TIMED;
+  }
+  else if (syscall_number == YALNIX_CUSTOM_2)
+  {
+    syscall_number = YALNIX_TTY_READ_TIMED;
+  }
+
   switch (syscall_number)
   {
   case (YALNIX_FORK):
@@ -123,6 +145,175 @@ void TrapKernelHandler(UserContext *uctxt)
     uctxt->regs[0] = rc;
     break;
   }
+  case (YALNIX_KILL):
+  {
+    TracePrintf(0, "Yalnix Kill Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int rc = SysKill(pid);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SET_LIMIT):
+  {
+    TracePrintf(0, "Yalnix SetLimit Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int resource = uctxt->regs[1];
+    int value = uctxt->regs[2];
+    int rc = SysSetLimit(pid, resource, value);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_FORKN):
+  {
+    TracePrintf(0, "Yalnix ForkN Syscall Handler\n");
+    pcb_t *current_pcb = GetCurrentProcess();
+    memcpy(&current_pcb->user_context, uctxt, sizeof(UserContext));
+    int n = uctxt->regs[0];
+    int *user_pids = (int *)uctxt->regs[1];
+
+    if (n > 0 && n <= FORKN_MAX &&
+        (!IsRegion1Address((void *)user_pids) || !IsRegion1Address((void *)(user_pids + n - 1))))
+    {
+      TracePrintf(0, "Invalid pids pointer not in region 1\n");
+      SysExit(ERROR);
+    }
+
+    int rc = SysForkN(uctxt, n, user_pids);
+    current_pcb = GetCurrentProcess();
+
+    memcpy(uctxt, &current_pcb->user_context, sizeof(UserContext));
+    uctxt->regs[0] = rc;
+    WriteRegister(REG_TLB_FLUSH, TLB_FLUSH_0);
+
+    TracePrintf(0, "ForkN returned %d\n", rc);
+    break;
+  }
+  case (YALNIX_MERGE_CTL):
+  {
+    TracePrintf(0, "Yalnix MergeControl Syscall Handler\n");
+    int scan_rate = uctxt->regs[0];
+    merge_stats_t *stats = (merge_stats_t *)uctxt->regs[1];
+
+    if (stats != NULL && (!IsRegion1Address((void *)stats) || !IsRegion1Address((void *)(stats + 1) - 1)))
+    {
+      TracePrintf(0, "Invalid stats pointer not in region 1\n");
+      SysExit(ERROR);
+    }
+
+    int rc = SysMergeControl(scan_rate, stats);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SET_PRIORITY):
+  {
+    TracePrintf(0, "Yalnix SetPriority Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int priority = uctxt->regs[1];
+    int rc = SysSetPriority(pid, priority);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_GET_PRIORITY):
+  {
+    TracePrintf(0, "Yalnix GetPriority Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int rc = SysGetPriority(pid);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_GROUP_CREATE):
+  {
+    TracePrintf(0, "Yalnix GroupCreate Syscall Handler\n");
+    int tickets = uctxt->regs[0];
+    int rc = SysGroupCreate(tickets);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_GROUP_DESTROY):
+  {
+    TracePrintf(0, "Yalnix GroupDestroy Syscall Handler\n");
+    int group = uctxt->regs[0];
+    int rc = SysGroupDestroy(group);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_GROUP_MOVE):
+  {
+    TracePrintf(0, "Yalnix GroupMove Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int group = uctxt->regs[1];
+    int rc = SysGroupMove(pid, group);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_GROUP_TICKS):
+  {
+    TracePrintf(0, "Yalnix GroupTicks Syscall Handler\n");
+    int group = uctxt->regs[0];
+    int rc = SysGroupTicks(group);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SET_REALTIME):
+  {
+    TracePrintf(0, "Yalnix SetRealTime Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int period = uctxt->regs[1];
+    int budget = uctxt->regs[2];
+    int rc = SysSetRealTime(pid, period, budget);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_WAIT_PERIOD):
+  {
+    TracePrintf(0, "Yalnix WaitPeriod Syscall Handler\n");
+    pcb_t *current_pcb = GetCurrentProcess();
+    memcpy(&current_pcb->user_context, uctxt, sizeof(UserContext));
+    int rc = SysWaitPeriod();
+    memcpy(uctxt, &current_pcb->user_context, sizeof(UserContext));
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_DEADLINE_MISSES):
+  {
+    TracePrintf(0, "Yalnix DeadlineMisses Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int rc = SysDeadlineMisses(pid);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SET_QUANTUM):
+  {
+    TracePrintf(0, "Yalnix SetQuantum Syscall Handler\n");
+    int ticks = uctxt->regs[0];
+    int rc = SysSetQuantum(ticks);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_YIELD):
+  {
+    TracePrintf(0, "Yalnix Yield Syscall Handler\n");
+    int rc = SysYield();
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SCHED_HINT):
+  {
+    TracePrintf(0, "Yalnix SchedHint Syscall Handler\n");
+    int hint = uctxt->regs[0];
+    int rc = SysSchedHint(hint);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_GET_LIMIT):
+  {
+    TracePrintf(0, "Yalnix GetLimit Syscall Handler\n");
+    int pid = uctxt->regs[0];
+    int resource = uctxt->regs[1];
+    int rc = SysGetLimit(pid, resource);
+    uctxt->regs[0] = rc;
+    break;
+  }
   case (YALNIX_LOCK_INIT):
   {
     TracePrintf(0, "Yalnix Lock Init Syscall Handler\n");
@@ -139,10 +330,12 @@ void TrapKernelHandler(UserContext *uctxt)
     break;
   }
   case (YALNIX_LOCK_ACQUIRE):
+  case (YALNIX_ACQUIRE_TIMED):
   {
     TracePrintf(0, "Yalnix Lock Acquire Syscall Handler\n");
     int lock_id = uctxt->regs[0];
-    int rc = Acquire(lock_id);
+    int ticks = (syscall_number == YALNIX_ACQUIRE_TIMED) ? uctxt->regs[1] : 0;
+    int rc = AcquireTimed(lock_id, ticks);
     uctxt->regs[0] = rc;
     break;
   }
@@ -154,6 +347,120 @@ void TrapKernelHandler(UserContext *uctxt)
     uctxt->regs[0] = rc;
     break;
   }
+  case (YALNIX_RWLOCK_INIT):
+  {
+    TracePrintf(0, "Yalnix RWLock Init Syscall Handler\n");
+    int *rwlock_id = (int *)uctxt->regs[0];
+
+    if (!IsRegion1Address((void *)rwlock_id) || !IsRegion1Address((void *)rwlock_id + sizeof(int) - 1))
+    {
+      TracePrintf(0, "Invalid lock ID pointer not in region 1\n");
+      SysExit(ERROR);
+    }
+
+    int rc = RWLockInit(rwlock_id);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_ACQUIRE_READ):
+  {
+    TracePrintf(0, "Yalnix AcquireRead Syscall Handler\n");
+    int rwlock_id = uctxt->regs[0];
+    int rc = AcquireRead(rwlock_id);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_ACQUIRE_WRITE):
+  {
+    TracePrintf(0, "Yalnix AcquireWrite Syscall Handler\n");
+    int rwlock_id = uctxt->regs[0];
+    int rc = AcquireWrite(rwlock_id);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_RELEASE_RW):
+  {
+    TracePrintf(0, "Yalnix ReleaseRW Syscall Handler\n");
+    int rwlock_id = uctxt->regs[0];
+    int rc = ReleaseRW(rwlock_id);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SEM_INIT):
+  {
+    TracePrintf(0, "Yalnix SemInit Syscall Handler\n");
+    int *sem_id = (int *)uctxt->regs[0];
+    int count = uctxt->regs[1];
+
+    if (!IsRegion1Address((void *)sem_id) || !IsRegion1Address((void *)sem_id + sizeof(int) - 1))
+    {
+      TracePrintf(0, "Invalid semaphore ID pointer not in region 1\n");
+      SysExit(ERROR);
+    }
+
+    int rc = SysSemInit(sem_id, count);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SEM_DOWN):
+  {
+    TracePrintf(0, "Yalnix SemDown Syscall Handler\n");
+    int sem_id = uctxt->regs[0];
+    int rc = SysSemDown(sem_id);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_SEM_UP):
+  {
+    TracePrintf(0, "Yalnix SemUp Syscall Handler\n");
+    int sem_id = uctxt->regs[0];
+    int count = uctxt->regs[1];
+    int rc = SysSemUp(sem_id, count);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_BARRIER_INIT):
+  {
+    TracePrintf(0, "Yalnix BarrierInit Syscall Handler\n");
+    int *barrier_id = (int *)uctxt->regs[0];
+    int parties = uctxt->regs[1];
+
+    if (!IsRegion1Address((void *)barrier_id) || !IsRegion1Address((void *)barrier_id + sizeof(int) - 1))
+    {
+      TracePrintf(0, "Invalid barrier ID pointer not in region 1\n");
+      SysExit(ERROR);
+    }
+
+    int rc = BarrierInit(barrier_id, parties);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_BARRIER_WAIT):
+  {
+    TracePrintf(0, "Yalnix BarrierWait Syscall Handler\n");
+    int barrier_id = uctxt->regs[0];
+    int rc = BarrierWait(barrier_id);
+    uctxt->regs[0] = rc;
+    break;
+  }
+  case (YALNIX_LOCK_PROFILE):
+  {
+    TracePrintf(0, "Yalnix LockProfile Syscall Handler\n");
+    int enable = uctxt->regs[0];
+    lock_profile_t *stats = (lock_profile_t *)uctxt->regs[1];
+    int count = uctxt->regs[2];
+
+    if (stats != NULL && count > 0 &&
+        (!IsRegion1Address((void *)stats) || !IsRegion1Address((void *)(stats + count) - 1)))
+    {
+      TracePrintf(0, "Invalid stats pointer not in region 1\n");
+      SysExit(ERROR);
+    }
+
+    int rc = SysLockProfile(enable, stats, count);
+    uctxt->regs[0] = rc;
+    break;
+  }
   case (YALNIX_RECLAIM):
   {
     TracePrintf(0, "Yalnix Reclaim Syscall Handler\n");
@@ -178,13 +485,15 @@ void TrapKernelHandler(UserContext *uctxt)
     break;
   }
   case (YALNIX_CVAR_WAIT):
+  case (YALNIX_CVAR_WAIT_TIMED):
   {
     TracePrintf(0, "Yalnix Cvar Wait Syscall Handler\n");
     int cvar_id = uctxt->regs[0];
     int lock_id = uctxt->regs[1];
+    int ticks = (syscall_number == YALNIX_CVAR_WAIT_TIMED) ? uctxt->regs[2] : 0;
     pcb_t *current = GetCurrentProcess();
     memcpy(&current->user_context, uctxt, sizeof(UserContext));
-    int rc = CvarWait(cvar_id, lock_id);
+    int rc = CvarWaitTimed(cvar_id, lock_id, ticks);
     memcpy(uctxt, &current->user_context, sizeof(UserContext));
     uctxt->regs[0] = rc;
     break;
@@ -221,11 +530,13 @@ void TrapKernelHandler(UserContext *uctxt)
     break;
   }
   case (YALNIX_PIPE_READ):
+  case (YALNIX_PIPE_READ_TIMED):
   {
     TracePrintf(0, "Yalnix Pipe Read Syscall Handler\n");
     int pipe_id = uctxt->regs[0];
     void *buffer = (void *)uctxt->regs[1];
     int length = uctxt->regs[2];
+    int ticks = (syscall_number == YALNIX_PIPE_READ_TIMED) ? uctxt->regs[3] : 0;
 
     if (!IsRegion1Address((void *)buffer) || !IsRegion1Address((void *)buffer + length - 1))
     {
@@ -233,7 +544,7 @@ void TrapKernelHandler(UserContext *uctxt)
       SysExit(ERROR);
     }
 
-    int rc = PipeRead(pipe_id, buffer, length);
+    int rc = PipeReadTimed(pipe_id, buffer, length, ticks);
     uctxt->regs[0] = rc;
     break;
   }
@@ -255,11 +566,13 @@ void TrapKernelHandler(UserContext *uctxt)
     break;
   }
   case (YALNIX_TTY_READ):
+  case (YALNIX_TTY_READ_TIMED):
   {
     TracePrintf(0, "Yalnix TTY Read Syscall Handler\n");
     int terminal = uctxt->regs[0];
     void *buffer = (void *)uctxt->regs[1];
     int length = uctxt->regs[2];
+    int ticks = (syscall_number == YALNIX_TTY_READ_TIMED) ? uctxt->regs[3] : 0;
 
     if (!IsRegion1Address((void *)buffer) || !IsRegion1Address((void *)buffer + length - 1))
     {
@@ -269,12 +582,16 @@ void TrapKernelHandler(UserContext *uctxt)
 
     pcb_t *current_pcb = GetCurrentProcess();
     memcpy(&current_pcb->user_context, uctxt, sizeof(UserContext));
-    int rc = SysTtyRead(terminal, buffer, length);
+    int rc = SysTtyReadTimed(terminal, buffer, length, ticks);
 
     // If we have data in our kernel buffer, copy it to user space now
     if (current_pcb->kernel_read_buffer != NULL && rc > 0)
     {
       // Copy from kernel buffer to user buffer
+      if (PrepareUserWrite(buffer, current_pcb->kernel_read_size) == ERROR)
+      {
+        SysExit(ERROR);
+      }
       memcpy(buffer, current_pcb->kernel_read_buffer, current_pcb->kernel_read_size);
 
       // Free the temporary buffer
@@ -311,16 +628,38 @@ void TrapKernelHandler(UserContext *uctxt)
 }
 void TrapClockHandler(UserContext *uctxt)
 {
-  UpdateDelayedPCB();
+  TimerTick();
   pcb_t *current = GetCurrentProcess();
   memcpy(&current->user_context, uctxt, sizeof(UserContext));
 
-  if (current->pid != idle_pcb->pid)
+  if (current == idle_pcb)
   {
-    pcb_enqueue(ready_processes, current);
+    // Nothing else wants the CPU, so spend the tick merging identical pages
+    MergeIdleScan();
+    if (!SchedHasReady())
+    {
+      return;
+    }
   }
+  else
+  {
+    // Stop processes that ran past their CPU limit, otherwise charge the tick
+    if (IsOverLimit(current, LIMIT_CPU_TICKS, current->cpu_ticks))
+    {
+      TracePrintf(0, "Process %d exceeded its CPU limit, terminating\n", current->pid);
+      SysExit(ERROR);
+    }
+    current->cpu_ticks++;
 
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+    // Only switch when the quantum is up and someone else can run
+    if (!SchedTick(current))
+    {
+      return;
+    }
+    MakeReady(current, SCHED_PREEMPTED);
+  }
+
+  pcb_t *next = PickNextProcess();
 
   int rc = KernelContextSwitch(KCSwitch, current, next);
 
@@ -339,8 +678,19 @@ void TrapMemoryHandler(UserContext *uctxt)
   TracePrintf(0, "The offending address is 0x%lx\n", uctxt->addr);
   TracePrintf(0, "The page is: %d\n", (unsigned int)uctxt->addr >> PAGESHIFT);
 
+  // A write to a page the idle scan merged gets its own copy
+  if (uctxt->code == YALNIX_ACCERR && IsMergedPage(GetCurrentProcess(), (void *)uctxt->addr))
+  {
+    pcb_t *current_pcb = GetCurrentProcess();
+    int index = VPN_TO_REGION1_INDEX((unsigned int)uctxt->addr >> PAGESHIFT);
+    if (SplitMergedPage(current_pcb, index) == ERROR)
+    {
+      TracePrintf(0, "Failed to split merged page, aborting current process\n");
+      SysExit(ERROR);
+    }
+  }
   // Check if this is a stack growth request
-  if (IsRegion1Address((void *)uctxt->addr) &&
+  else if (IsRegion1Address((void *)uctxt->addr) &&
       IsAddressBelowStackAndAboveBreak((void *)uctxt->addr))
   {
 
@@ -418,8 +768,7 @@ void TrapTtyReceiveHandler(UserContext *uctxt)
     }
 
     reader->state = PCB_STATE_READY;
-    pcb_remove(blocked_processes, reader);
-    pcb_enqueue(ready_processes, reader);
+    MakeReady(reader, SCHED_TTY_INPUT);
   }
 
   TracePrintf(0, "TrapTtyReceiveHandler: After processing, buffer has %d bytes left\n",
@@ -477,12 +826,11 @@ void TrapTtyTransmitHandler(UserContext *uctxt)
       writer->user_context.regs[0] = writer->tty_write_len;
 
       writer->state = PCB_STATE_READY;
-      pcb_remove(blocked_processes, writer);
-      pcb_enqueue(ready_processes, writer);
+      MakeReady(writer, SCHED_WOKEN);
     }
     else
     {
-      TracePrintf(0, "TrapTtyTransmitHandler: Error - No current writer\n");
+      TracePrintf(1, "TrapTtyTransmitHandler: Writer was killed before the write completed\n");
     }
 
     // If there are more writers waiting, start the next one
@@ -4,6 +4,8 @@
 #include "process.h"
 #include "ylib.h"
 #include "yalnix.h"
+#include "scheduler.h"
+#include "synchronization.h"
 
 // Global array of TTY data structures
 tty_data_t tty_data[NUM_TERMINALS];
@@ -46,7 +48,7 @@ void StartTtyWrite(int terminal, pcb_t *writer, void *buf, int len)
     TracePrintf(0, "StartTtyWrite: Failed to allocate write buffer\n");
     writer->user_context.regs[0] = ERROR;
     writer->state = PCB_STATE_READY;
-    pcb_enqueue(ready_processes, writer);
+    MakeReady(writer, SCHED_WOKEN);
     return;
   }
 
@@ -64,10 +66,15 @@ void StartTtyWrite(int terminal, pcb_t *writer, void *buf, int len)
 }
 
 int SysTtyRead(int tty_id, void *buf, int len)
+{
+  return SysTtyReadTimed(tty_id, buf, len, 0);
+}
+
+int SysTtyReadTimed(int tty_id, void *buf, int len, int ticks)
 {
   TracePrintf(1, "SysTtyRead: Terminal %d, Buffer %p, Length %d\n", tty_id, buf, len);
 
-  if (tty_id < 0 || tty_id >= NUM_TERMINALS || buf == NULL || len <= 0)
+  if (tty_id < 0 || tty_id >= NUM_TERMINALS || buf == NULL || len <= 0 || ticks < 0)
   {
     TracePrintf(0, "SysTtyRead: Invalid arguments\n");
     return ERROR;
@@ -125,16 +132,21 @@ int SysTtyRead(int tty_id, void *buf, int len)
 
   // Block the process
   pcb->state = PCB_STATE_BLOCKED;
-  pcb_enqueue(blocked_processes, pcb);
+  StartWaitTimeout(pcb, ticks);
 
   // Switch to next process
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+  pcb_t *next = PickNextProcess();
   TracePrintf(1, "SysTtyRead: Switching to process %d\n", next->pid);
 
   KernelContextSwitch(KCSwitch, pcb, next);
 
   // When we wake up, check if there was an error or how many bytes were read
   TracePrintf(1, "SysTtyRead: Process %d woken up\n", pcb->pid);
+  if (EndWaitTimeout(pcb))
+  {
+    TracePrintf(1, "SysTtyRead: Process %d timed out on terminal %d\n", pcb->pid, tty_id);
+    return TIMEOUT;
+  }
 
   // The return value should be stored in reg[0] by the trap handler
   return pcb->user_context.regs[0];
@@ -173,10 +185,9 @@ int SysTtyWrite(int tty_id, void *buf, int len)
   }
 
   pcb->state = PCB_STATE_BLOCKED;
-  pcb_enqueue(blocked_processes, pcb);
 
   // Switch to next process
-  pcb_t *next = (ready_processes->head != NULL) ? pcb_dequeue(ready_processes) : idle_pcb;
+  pcb_t *next = PickNextProcess();
 
   KernelContextSwitch(KCSwitch, pcb, next);
 
@@ -184,3 +195,15 @@ int SysTtyWrite(int tty_id, void *buf, int len)
   TracePrintf(1, "SysTtyWrite: Process %d woken up, write complete\n", pcb->pid);
   return len;
 }
+
+void CancelTtyWrite(pcb_t *pcb)
+{
+  for (int i = 0; i < NUM_TERMINALS; i++)
+  {
+    if (tty_data[i].current_writer == pcb)
+    {
+      TracePrintf(1, "CancelTtyWrite: Detaching PID %d from terminal %d\n", pcb->pid, i);
+      tty_data[i].current_writer = NULL;
+    }
+  }
+}
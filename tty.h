@@ -68,6 +68,24 @@ void StartTtyWrite(int terminal, pcb_t *writer, void *buf, int len);
  */
 int SysTtyRead(int tty_id, void *buf, int len);
 
+/**
+ * SysTtyReadTimed - System call to read from a terminal with a timeout
+ *
+ * Like SysTtyRead, but gives up if no input arrives within 'ticks'.
+ *
+ * Parameters:
+ *   tty_id - Terminal ID (0 to NUM_TERMINALS-1)
+ *   buf - Buffer to store read data
+ *   len - Maximum number of bytes to read
+ *   ticks - Most clock ticks to wait, 0 to wait forever
+ *
+ * Returns:
+ *   - Number of bytes read on success
+ *   - TIMEOUT if no input arrived in time
+ *   - ERROR if tty_id is invalid, buf is NULL, len <= 0, or ticks < 0
+ */
+int SysTtyReadTimed(int tty_id, void *buf, int len, int ticks);
+
 /**
  * SysTtyWrite - System call to write to a terminal
  *
@@ -86,6 +104,17 @@ int SysTtyRead(int tty_id, void *buf, int len);
  */
 int SysTtyWrite(int tty_id, void *buf, int len);
 
+/**
+ * CancelTtyWrite - Detach a process from any write in progress
+ *
+ * Called when a process is killed while its output is being transmitted.
+ * The transmission finishes, but no process is woken when it completes.
+ *
+ * Parameters:
+ *   pcb - Pointer to PCB of the killed process
+ */
+void CancelTtyWrite(pcb_t *pcb);
+
 // External global array of TTY data structures
 extern tty_data_t tty_data[NUM_TERMINALS];
 